@@ -0,0 +1,282 @@
+/*
+ * blob.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// blob.c - Imgenes de configuracin con dos copias (A/B) en la memoria
+//          24LC512.
+//
+//*****************************************************************************
+
+#include "blob.h"
+#include "workbuf.h"
+
+// La copia vigente se guarda en la FRAM principal: cambiarla es escribir un solo byte.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(blob)
+static M24LC512_BlobStore blob = {0};
+#elif defined(__GNUC__)
+static M24LC512_BlobStore blob __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+// Imagen en curso. Se pierde con un reset, igual que la copia inactiva a medio escribir.
+static uint16_t blobLength;
+static uint16_t blobVersion;
+static uint16_t blobSequence;
+static uint16_t blobOffset;
+static uint16_t blobCrc;
+static bool blobOpen = false;
+
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_blobAddress(const uint8_t Slot)
+{
+    return (blob.startPage + ((uint16_t)Slot * M24LC512_BLOB_PAGES)) * M24LC512_MAXPAGEWRITE;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_blobCheck(const uint8_t Slot, uint16_t *Length, uint16_t *Version, uint16_t *Sequence)
+{
+    uint16_t address = M24LC512_blobAddress(Slot);
+    uint16_t remaining;
+    uint16_t pieceSize;
+    uint16_t stored;
+    uint16_t crc;
+
+    M24LC512_sequentialRead(address, M24LC512_workBuffer, M24LC512_BLOB_HEADER_SIZE);
+
+    *Length = ((uint16_t)M24LC512_workBuffer[0] << 8) | M24LC512_workBuffer[1];
+    *Version = ((uint16_t)M24LC512_workBuffer[2] << 8) | M24LC512_workBuffer[3];
+    *Sequence = ((uint16_t)M24LC512_workBuffer[4] << 8) | M24LC512_workBuffer[5];
+    stored = ((uint16_t)M24LC512_workBuffer[6] << 8) | M24LC512_workBuffer[7];
+
+    if(*Length > M24LC512_BLOB_CAPACITY)
+    {
+        return false;                                           // Copia nunca escrita (0xFF) o encabezado daado
+    }
+
+    // El CRC cubre la longitud, la version, la secuencia y la imagen.
+    crc = M24LC512_crcContinue(M24LC512_BLOB_CRC_SEED, M24LC512_workBuffer, M24LC512_BLOB_HEADER_SIZE - 2);
+
+    address += M24LC512_BLOB_HEADER_SIZE;
+    remaining = *Length;
+
+    while(remaining > 0)
+    {
+        pieceSize = (remaining > M24LC512_BLOB_PIECE) ? M24LC512_BLOB_PIECE : remaining;
+
+        M24LC512_readRange(address, M24LC512_workBuffer, pieceSize);
+        crc = M24LC512_crcContinue(crc, M24LC512_workBuffer, pieceSize);
+
+        address += pieceSize;
+        remaining -= pieceSize;
+    }
+
+    return (crc == stored);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobInit(const uint16_t StartPage)
+{
+    uint8_t state;
+
+    if(!M24LC512_reserveZone(M24LC512_ZONE_BLOB, StartPage, 2 * M24LC512_BLOB_PAGES))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    blob.startPage = StartPage;
+    blob.configured = 1;
+    blob.active = M24LC512_BLOB_NONE;
+
+    M24LC512_framRestore(state);
+
+    blobOpen = false;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobMount(const uint16_t StartPage)
+{
+    uint16_t length;
+    uint16_t version;
+    uint16_t sequence[2];
+    bool valid[2];
+    uint8_t active;
+    uint8_t state;
+    uint8_t i;
+
+    if(!M24LC512_blobInit(StartPage))
+    {
+        return false;
+    }
+
+    // Un reset durante M24LC512_blobCommit() puede dejar las dos copias validas: la mas nueva es la ultima confirmada.
+    for(i = 0 ; i < 2 ; i++)
+    {
+        valid[i] = M24LC512_blobCheck(i, &length, &version, &sequence[i]);
+    }
+
+    if(valid[0] && valid[1])
+    {
+        // Aritmetica de numeros de serie: la copia 1 es mas nueva si esta a menos de media vuelta por delante.
+        active = ((int16_t)(sequence[1] - sequence[0]) > 0) ? 1 : 0;
+    }
+    else if(valid[0] || valid[1])
+    {
+        active = valid[0] ? 0 : 1;
+    }
+    else
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+    blob.active = active;
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobBegin(const uint16_t Length, const uint16_t Version)
+{
+    uint8_t header[M24LC512_BLOB_HEADER_SIZE - 2];
+    uint8_t slot = (blob.active == 0) ? 1 : 0;
+
+    if(!blob.configured || (Length > M24LC512_BLOB_CAPACITY))
+    {
+        return false;
+    }
+
+    // Se continua la secuencia de la otra copia, sea valida o no: la nueva queda siempre por delante.
+    M24LC512_sequentialRead(M24LC512_blobAddress(1 - slot) + 4, header, 2);
+
+    blobLength = Length;
+    blobVersion = Version;
+    blobSequence = (((uint16_t)header[0] << 8) | header[1]) + 1;
+    blobOffset = 0;
+
+    header[0] = (uint8_t)(Length >> 8);
+    header[1] = (uint8_t)Length;
+    header[2] = (uint8_t)(Version >> 8);
+    header[3] = (uint8_t)Version;
+    header[4] = (uint8_t)(blobSequence >> 8);
+    header[5] = (uint8_t)blobSequence;
+    blobCrc = M24LC512_crcContinue(M24LC512_BLOB_CRC_SEED, header, sizeof(header));
+
+    blobOpen = true;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobWrite(const uint8_t *Data, const uint16_t Size)
+{
+    // Con ninguna imagen vigente se escribe la copia 0.
+    uint8_t slot = (blob.active == 0) ? 1 : 0;
+
+    if(!blobOpen || (Size > (blobLength - blobOffset)))
+    {
+        return false;
+    }
+
+    blobCrc = M24LC512_crcContinue(blobCrc, Data, Size);
+
+    if(!M24LC512_rangeProgram(M24LC512_blobAddress(slot) + M24LC512_BLOB_HEADER_SIZE + blobOffset, Data, Size))
+    {
+        blobOpen = false;                                       // La imagen ya no se puede confirmar
+        return false;
+    }
+
+    blobOffset += Size;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobCommit(void)
+{
+    uint8_t slot = (blob.active == 0) ? 1 : 0;
+    uint8_t header[M24LC512_BLOB_HEADER_SIZE];
+    uint16_t length;
+    uint16_t version;
+    uint16_t sequence;
+    uint8_t state;
+
+    if(!blobOpen || (blobOffset != blobLength))
+    {
+        return false;
+    }
+
+    blobOpen = false;
+
+    header[0] = (uint8_t)(blobLength >> 8);
+    header[1] = (uint8_t)blobLength;
+    header[2] = (uint8_t)(blobVersion >> 8);
+    header[3] = (uint8_t)blobVersion;
+    header[4] = (uint8_t)(blobSequence >> 8);
+    header[5] = (uint8_t)blobSequence;
+    header[6] = (uint8_t)(blobCrc >> 8);
+    header[7] = (uint8_t)blobCrc;
+
+    // Se relee la copia completa: el CRC guardado debe coincidir con lo que realmente quedo en la memoria.
+    if(!M24LC512_rangeProgram(M24LC512_blobAddress(slot), header, M24LC512_BLOB_HEADER_SIZE) ||
+       !M24LC512_blobCheck(slot, &length, &version, &sequence))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+    blob.active = slot;                                         // Un solo byte: el cambio es atomico
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobInfo(uint16_t *Length, uint16_t *Version)
+{
+    uint8_t header[M24LC512_BLOB_HEADER_SIZE];
+
+    if(!blob.configured || (blob.active == M24LC512_BLOB_NONE))
+    {
+        return false;
+    }
+
+    M24LC512_sequentialRead(M24LC512_blobAddress(blob.active), header, M24LC512_BLOB_HEADER_SIZE);
+
+    *Length = ((uint16_t)header[0] << 8) | header[1];
+    *Version = ((uint16_t)header[2] << 8) | header[3];
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobRead(const uint16_t Offset, uint8_t *Data, const uint16_t Size)
+{
+    uint16_t length;
+    uint16_t version;
+
+    if((Size == 0) || !M24LC512_blobInfo(&length, &version) || (Offset > length) || (Size > (length - Offset)))
+    {
+        return false;
+    }
+
+    M24LC512_readRange(M24LC512_blobAddress(blob.active) + M24LC512_BLOB_HEADER_SIZE + Offset, Data, Size);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_blobVerify(void)
+{
+    uint16_t length;
+    uint16_t version;
+    uint16_t sequence;
+
+    if(!blob.configured || (blob.active == M24LC512_BLOB_NONE))
+    {
+        return false;
+    }
+
+    return M24LC512_blobCheck(blob.active, &length, &version, &sequence);
+}
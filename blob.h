@@ -0,0 +1,201 @@
+/**
+  * @file     blob.h
+  * @brief    Imgenes de configuracin con dos copias (A/B) en la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// blob.h - Imgenes de configuracin con dos copias (A/B) en la memoria
+//          24LC512.
+//
+//*****************************************************************************
+
+#ifndef BLOB_H_
+#define BLOB_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "partition.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Pginas de cada copia. La zona ocupa el doble.
+//*****************************************************************************
+#define M24LC512_BLOB_PAGES         16
+
+//*****************************************************************************
+//! \details Encabezado al comienzo de cada copia: longitud, versin,
+//!          secuencia y CRC16 (2 bytes cada uno). La versin es la de la
+//!          aplicacin; la secuencia la incrementa la librera en cada imagen
+//!          para saber cul de las dos copias es la ms nueva.
+//*****************************************************************************
+#define M24LC512_BLOB_HEADER_SIZE   8
+
+//*****************************************************************************
+//! \details Tamao mximo de una imagen.
+//*****************************************************************************
+#define M24LC512_BLOB_CAPACITY      ((M24LC512_BLOB_PAGES * M24LC512_MAXPAGEWRITE) - M24LC512_BLOB_HEADER_SIZE)
+
+//*****************************************************************************
+//! \details Copia activa cuando todava no se guard ninguna imagen.
+//*****************************************************************************
+#define M24LC512_BLOB_NONE          0xFF
+
+//*****************************************************************************
+//! \details Semilla del CRC16 de las imgenes.
+//*****************************************************************************
+#define M24LC512_BLOB_CRC_SEED      0xFFFF
+
+//*****************************************************************************
+//! \details Bytes que se releen por transaccin al verificar una imagen.
+//*****************************************************************************
+#define M24LC512_BLOB_PIECE         32
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Estado de las copias, guardado en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t startPage;     //!< Primera pgina de la copia 0.
+    uint8_t configured;     //!< Distinto de cero si la zona est configurada.
+    uint8_t active;         //!< Copia vigente o \b M24LC512_BLOB_NONE.
+} M24LC512_BlobStore;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura la zona de las imgenes.
+//!
+//! \details \b Descripcin \n
+//!          Las dos copias ocupan 2 * \b M24LC512_BLOB_PAGES pginas desde
+//!          \b StartPage, que se reservan como \b M24LC512_ZONE_BLOB con
+//!          \a M24LC512_reserveZone(). Deja sin
+//!          imagen vigente, por lo que solo se llama al preparar el equipo;
+//!          al arrancar se usa \a M24LC512_blobMount().
+//!
+//! \param StartPage Primera pgina de la zona.
+//!
+//! \return \c true si la zona entra antes de las pginas de reserva y no se
+//!         superpone con una particin ni con otra zona.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_blobInit(const uint16_t StartPage);
+
+//*****************************************************************************
+//! \brief Configura la zona de las imgenes y busca la copia vigente.
+//!
+//! \details \b Descripcin \n
+//!          Relee las dos copias y verifica el CRC de cada una. Si las dos
+//!          son vlidas queda vigente la de secuencia ms nueva, comparada
+//!          con aritmtica de nmeros de serie para que la vuelta de los 16
+//!          bits no importe. La versin de la aplicacin no interviene, as
+//!          que se puede repetir o volver atrs. Se llama al
+//!          arrancar, por ejemplo cuando se perdi la FRAM al cargar otro
+//!          firmware.
+//!
+//! \param StartPage Primera pgina de la zona.
+//!
+//! \return \c true si hay una imagen vigente; con \c false la zona queda
+//!         configurada sin imagen si entra antes de las pginas de reserva.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE, \b SYSCFG0,
+//!            \b CRCINIRES y \b CRCDI.
+//*****************************************************************************
+bool M24LC512_blobMount(const uint16_t StartPage);
+
+//*****************************************************************************
+//! \brief Comienza a escribir una imagen nueva en la copia inactiva.
+//!
+//! \details \b Descripcin \n
+//!          La secuencia de la imagen nueva es la de la otra copia ms uno,
+//!          as queda como la ms nueva aunque la otra copia est daada.
+//!
+//! \param Length Tamao de la imagen, hasta \b M24LC512_BLOB_CAPACITY.
+//! \param Version Versin de la imagen.
+//!
+//! \return \c true si la zona est configurada y la imagen entra.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE, \b CRCINIRES y
+//!            \b CRCDI.
+//*****************************************************************************
+bool M24LC512_blobBegin(const uint16_t Length, const uint16_t Version);
+
+//*****************************************************************************
+//! \brief Agrega datos a la imagen que se est escribiendo.
+//!
+//! \details \b Descripcin \n
+//!          Los datos se escriben por pginas en la copia inactiva a medida
+//!          que llegan, as la imagen puede ser ms grande que la RAM. La
+//!          copia vigente no se toca.
+//!
+//! \param *Data Datos.
+//! \param Size Cantidad de datos, sin pasar la longitud indicada en
+//!        \a M24LC512_blobBegin().
+//!
+//! \return \c true si se escribieron los datos.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR y \b UCB0IE.
+//*****************************************************************************
+bool M24LC512_blobWrite(const uint8_t *Data, const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Termina la imagen y la hace vigente.
+//!
+//! \details \b Descripcin \n
+//!          Escribe el encabezado de la copia, la relee completa y compara su
+//!          CRC con el calculado mientras se escriba. Solo si coincide
+//!          cambia la copia vigente, con una nica escritura de un byte en la
+//!          FRAM: un reset en cualquier momento anterior deja vigente la
+//!          imagen anterior completa.
+//!
+//! \return \c true si la imagen nueva qued vigente.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_blobCommit(void);
+
+//*****************************************************************************
+//! \brief Devuelve la longitud y la versin de la imagen vigente.
+//!
+//! \param *Length Devuelve el tamao de la imagen.
+//! \param *Version Devuelve la versin de la imagen.
+//!
+//! \return \c false si no hay imagen vigente.
+//*****************************************************************************
+bool M24LC512_blobInfo(uint16_t *Length, uint16_t *Version);
+
+//*****************************************************************************
+//! \brief Lee parte de la imagen vigente.
+//!
+//! \param Offset Posicin dentro de la imagen.
+//! \param *Data Buffer donde se guardan los datos ledos.
+//! \param Size Cantidad de datos.
+//!
+//! \return \c false si no hay imagen vigente o el rango se pasa de ella.
+//*****************************************************************************
+bool M24LC512_blobRead(const uint16_t Offset, uint8_t *Data,
+                       const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Verifica el CRC de la imagen vigente.
+//!
+//! \return \c true si la imagen est intacta.
+//*****************************************************************************
+bool M24LC512_blobVerify(void);
+
+#endif /* BLOB_H_ */
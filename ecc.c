@@ -0,0 +1,348 @@
+/*
+ * ecc.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// ecc.c - Correccin de errores SECDED en zonas de la memoria 24LC512.
+//
+//*****************************************************************************
+
+#include "ecc.h"
+#include "workbuf.h"
+
+// Las zonas y los contadores se guardan en la FRAM principal.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(ecc)
+static M24LC512_EccState ecc = {0};
+#elif defined(__GNUC__)
+static M24LC512_EccState ecc __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+// Columnas de la matriz de control (codigo de Hsiao 72,64): una por bit de datos, todas distintas y de peso impar
+// (las 56 de peso 3 y 8 de peso 5). Los bits de control son las columnas de peso 1. Es constante, queda en FRAM.
+static const uint8_t eccColumn[M24LC512_ECC_WORD * 8] =
+{
+    0x07, 0x0B, 0x13, 0x23, 0x43, 0x83, 0x0D, 0x15,
+    0x25, 0x45, 0x85, 0x19, 0x29, 0x49, 0x89, 0x31,
+    0x51, 0x91, 0x61, 0xA1, 0xC1, 0x0E, 0x16, 0x26,
+    0x46, 0x86, 0x1A, 0x2A, 0x4A, 0x8A, 0x32, 0x52,
+    0x92, 0x62, 0xA2, 0xC2, 0x1C, 0x2C, 0x4C, 0x8C,
+    0x34, 0x54, 0x94, 0x64, 0xA4, 0xC4, 0x38, 0x58,
+    0x98, 0x68, 0xA8, 0xC8, 0x70, 0xB0, 0xD0, 0xE0,
+    0x1F, 0x3E, 0x7C, 0xF8, 0xF1, 0xE3, 0xC7, 0x8F
+};
+
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_eccEncode(const uint8_t *Word)
+{
+    const uint8_t *column;
+    uint8_t check = 0;
+    uint8_t value;
+    uint8_t i;
+
+    // El byte de control es el XOR de las columnas de los bits de datos en uno.
+    for(i = 0 ; i < M24LC512_ECC_WORD ; i++)
+    {
+        column = &eccColumn[i * 8];
+
+        for(value = Word[i] ; value != 0 ; value >>= 1, column++)
+        {
+            if(value & 0x01)
+            {
+                check ^= *column;
+            }
+        }
+    }
+
+    return check;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_eccDecode(uint8_t *Codeword)
+{
+    uint8_t syndrome = M24LC512_eccEncode(Codeword) ^ Codeword[M24LC512_ECC_WORD];
+    uint8_t parity = syndrome;
+    uint8_t i;
+
+    if(syndrome == 0)
+    {
+        return M24LC512_ECC_OK;
+    }
+
+    parity ^= parity >> 4;
+    parity ^= parity >> 2;
+    parity ^= parity >> 1;
+
+    // Un error simple deja un sindrome de peso impar; dos errores, uno de peso par.
+    if(parity & 0x01)
+    {
+        if((syndrome & (syndrome - 1)) == 0)
+        {
+            Codeword[M24LC512_ECC_WORD] ^= syndrome;             // Error en el byte de control
+            return M24LC512_ECC_CORRECTED;
+        }
+
+        for(i = 0 ; i < sizeof(eccColumn) ; i++)
+        {
+            if(eccColumn[i] == syndrome)
+            {
+                Codeword[i / 8] ^= (uint8_t)(1 << (i % 8));
+                return M24LC512_ECC_CORRECTED;
+            }
+        }
+    }
+
+    return M24LC512_ECC_UNCORRECTABLE;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_eccCheck(uint8_t *Codeword)
+{
+    uint8_t result = M24LC512_eccDecode(Codeword);
+    uint8_t state;
+
+    if(result != M24LC512_ECC_OK)
+    {
+        state = M24LC512_framUnlock();
+
+        if(result == M24LC512_ECC_CORRECTED)
+        {
+            ecc.corrected++;
+        }
+        else
+        {
+            ecc.uncorrectable++;
+        }
+
+        M24LC512_framRestore(state);
+    }
+
+    return result;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_eccValid(const uint8_t Range, const uint16_t Offset, const uint16_t Size)
+{
+    return (Range < M24LC512_ECC_RANGES) && (Size > 0) &&
+           (((uint32_t)Offset + Size) <= ((uint32_t)ecc.range[Range].pageCount * M24LC512_ECC_PAGE_DATA));
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_eccAddress(const uint8_t Range, const uint16_t Page, const uint16_t Word)
+{
+    return ((ecc.range[Range].startPage + Page) * M24LC512_MAXPAGEWRITE) + (Word * M24LC512_ECC_CODEWORD);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_eccInit(const uint8_t Range, const uint16_t StartPage, const uint16_t PageCount)
+{
+    uint8_t state;
+
+    if((Range >= M24LC512_ECC_RANGES) || !M24LC512_reserveZone(M24LC512_ZONE_ECC + Range, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    ecc.range[Range].startPage = StartPage;
+    ecc.range[Range].pageCount = PageCount;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_eccCapacity(const uint8_t Range)
+{
+    return (Range < M24LC512_ECC_RANGES) ? (ecc.range[Range].pageCount * M24LC512_ECC_PAGE_DATA) : 0;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_eccWrite(const uint8_t Range, uint16_t Offset, const uint8_t *Data, uint16_t Size)
+{
+    uint16_t page;
+    uint16_t pageOffset;
+    uint16_t chunkSize;
+    uint16_t first;
+    uint16_t last;
+    uint16_t position;
+    uint16_t i;
+    bool ok = true;
+
+    if(!M24LC512_eccValid(Range, Offset, Size))
+    {
+        return false;
+    }
+
+    while(Size > 0)
+    {
+        page = Offset / M24LC512_ECC_PAGE_DATA;
+        pageOffset = Offset % M24LC512_ECC_PAGE_DATA;
+        chunkSize = M24LC512_ECC_PAGE_DATA - pageOffset;
+        if(chunkSize > Size)
+        {
+            chunkSize = Size;
+        }
+
+        first = pageOffset / M24LC512_ECC_WORD;
+        last = (pageOffset + chunkSize - 1) / M24LC512_ECC_WORD;
+
+        // Las palabras de los extremos que no se escriben completas conservan el resto de sus datos. Si no se pueden
+        // corregir no se escriben: un byte de control nuevo haria pasar por buenos los datos daados.
+        if((pageOffset % M24LC512_ECC_WORD) != 0)
+        {
+            M24LC512_readRange(M24LC512_eccAddress(Range, page, first), M24LC512_workBuffer, M24LC512_ECC_CODEWORD);
+            if(M24LC512_eccCheck(M24LC512_workBuffer) == M24LC512_ECC_UNCORRECTABLE)
+            {
+                return false;
+            }
+        }
+
+        if((((pageOffset + chunkSize) % M24LC512_ECC_WORD) != 0) &&
+           ((last != first) || ((pageOffset % M24LC512_ECC_WORD) == 0)))
+        {
+            M24LC512_readRange(M24LC512_eccAddress(Range, page, last), &M24LC512_workBuffer[(last - first) * M24LC512_ECC_CODEWORD],
+                               M24LC512_ECC_CODEWORD);
+            if(M24LC512_eccCheck(&M24LC512_workBuffer[(last - first) * M24LC512_ECC_CODEWORD]) == M24LC512_ECC_UNCORRECTABLE)
+            {
+                return false;
+            }
+        }
+
+        for(i = 0 ; i < chunkSize ; i++)
+        {
+            position = pageOffset + i;
+            M24LC512_workBuffer[((position / M24LC512_ECC_WORD) - first) * M24LC512_ECC_CODEWORD + (position % M24LC512_ECC_WORD)] = Data[i];
+        }
+
+        for(i = 0 ; i <= (last - first) ; i++)
+        {
+            M24LC512_workBuffer[i * M24LC512_ECC_CODEWORD + M24LC512_ECC_WORD] = M24LC512_eccEncode(&M24LC512_workBuffer[i * M24LC512_ECC_CODEWORD]);
+        }
+
+        // Todas las palabras de la pagina en una sola transaccion y un solo ciclo de escritura.
+        if(!M24LC512_pageProgram(M24LC512_eccAddress(Range, page, first), M24LC512_workBuffer,
+                                 (last - first + 1) * M24LC512_ECC_CODEWORD))
+        {
+            ok = false;
+        }
+
+        Offset += chunkSize;
+        Data += chunkSize;
+        Size -= chunkSize;
+    }
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_eccRead(const uint8_t Range, uint16_t Offset, uint8_t *Data, uint16_t Size)
+{
+    uint16_t page;
+    uint16_t pageOffset;
+    uint16_t chunkSize;
+    uint16_t first;
+    uint16_t last;
+    uint16_t position;
+    uint16_t i;
+    uint8_t status;
+    uint8_t result = M24LC512_ECC_OK;
+
+    if(!M24LC512_eccValid(Range, Offset, Size))
+    {
+        return M24LC512_ECC_INVALID;
+    }
+
+    while(Size > 0)
+    {
+        page = Offset / M24LC512_ECC_PAGE_DATA;
+        pageOffset = Offset % M24LC512_ECC_PAGE_DATA;
+        chunkSize = M24LC512_ECC_PAGE_DATA - pageOffset;
+        if(chunkSize > Size)
+        {
+            chunkSize = Size;
+        }
+
+        first = pageOffset / M24LC512_ECC_WORD;
+        last = (pageOffset + chunkSize - 1) / M24LC512_ECC_WORD;
+
+        M24LC512_readRange(M24LC512_eccAddress(Range, page, first), M24LC512_workBuffer, (last - first + 1) * M24LC512_ECC_CODEWORD);
+
+        for(i = 0 ; i <= (last - first) ; i++)
+        {
+            status = M24LC512_eccCheck(&M24LC512_workBuffer[i * M24LC512_ECC_CODEWORD]);
+            if(status > result)
+            {
+                result = status;
+            }
+        }
+
+        for(i = 0 ; i < chunkSize ; i++)
+        {
+            position = pageOffset + i;
+            Data[i] = M24LC512_workBuffer[((position / M24LC512_ECC_WORD) - first) * M24LC512_ECC_CODEWORD + (position % M24LC512_ECC_WORD)];
+        }
+
+        Offset += chunkSize;
+        Data += chunkSize;
+        Size -= chunkSize;
+    }
+
+    return result;
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_eccScrubPage(const uint8_t Range, const uint16_t Page)
+{
+    uint16_t address;
+    uint8_t status;
+    uint8_t result = M24LC512_ECC_OK;
+    uint8_t i;
+    bool corrected = false;
+
+    if((Range >= M24LC512_ECC_RANGES) || (Page >= ecc.range[Range].pageCount))
+    {
+        return M24LC512_ECC_INVALID;
+    }
+
+    address = M24LC512_eccAddress(Range, Page, 0);
+
+    M24LC512_readRange(address, M24LC512_workBuffer, M24LC512_ECC_PAGE_WORDS * M24LC512_ECC_CODEWORD);
+
+    for(i = 0 ; i < M24LC512_ECC_PAGE_WORDS ; i++)
+    {
+        status = M24LC512_eccCheck(&M24LC512_workBuffer[i * M24LC512_ECC_CODEWORD]);
+        if(status == M24LC512_ECC_CORRECTED)
+        {
+            corrected = true;
+        }
+
+        if(status > result)
+        {
+            result = status;
+        }
+    }
+
+    // Se reescribe la pagina con las palabras corregidas antes de que se sume un segundo error; las que no se pueden
+    // corregir quedan como estaban.
+    if(corrected && !M24LC512_pageProgram(address, M24LC512_workBuffer, M24LC512_ECC_PAGE_WORDS * M24LC512_ECC_CODEWORD))
+    {
+        result = M24LC512_ECC_WRITE_FAILED;
+    }
+
+    return result;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_eccStats(uint16_t *Corrected, uint16_t *Uncorrectable)
+{
+    *Corrected = ecc.corrected;
+    *Uncorrectable = ecc.uncorrectable;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_eccClearStats(void)
+{
+    uint8_t state = M24LC512_framUnlock();
+
+    ecc.corrected = 0;
+    ecc.uncorrectable = 0;
+
+    M24LC512_framRestore(state);
+}
@@ -0,0 +1,205 @@
+/**
+  * @file     ecc.h
+  * @brief    Correccin de errores SECDED en zonas de la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// ecc.h - Correccin de errores SECDED en zonas de la memoria 24LC512.
+//
+//*****************************************************************************
+
+#ifndef ECC_H_
+#define ECC_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "partition.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Cantidad de zonas protegidas. Cada una se reserva como
+//!          \b M24LC512_ZONE_ECC + nmero de zona.
+//*****************************************************************************
+#define M24LC512_ECC_RANGES         4
+
+_Static_assert((M24LC512_ZONE_ECC + M24LC512_ECC_RANGES) <= M24LC512_ZONES, "Faltan zonas reservadas para ECC");
+
+//*****************************************************************************
+//! \details Cada palabra de 8 bytes se guarda con un byte de control: corrige
+//!          un bit y detecta dos en cada palabra.
+//*****************************************************************************
+//! @name Palabras de cdigo
+//! @{
+#define M24LC512_ECC_WORD           8
+#define M24LC512_ECC_CODEWORD       (M24LC512_ECC_WORD + 1)
+#define M24LC512_ECC_PAGE_WORDS     (M24LC512_MAXPAGEWRITE / M24LC512_ECC_CODEWORD)
+#define M24LC512_ECC_PAGE_DATA      (M24LC512_ECC_PAGE_WORDS * M24LC512_ECC_WORD)
+//! @}
+
+//*****************************************************************************
+//! \details Resultado de \a M24LC512_eccRead(). Si hay varias palabras se
+//!          devuelve el peor.
+//*****************************************************************************
+//! @name Resultados
+//! @{
+#define M24LC512_ECC_OK             0   //!< Sin errores.
+#define M24LC512_ECC_CORRECTED      1   //!< Se corrigi un bit.
+#define M24LC512_ECC_UNCORRECTABLE  2   //!< Dos bits o ms en una palabra.
+#define M24LC512_ECC_INVALID        3   //!< Zona o rango invlido.
+#define M24LC512_ECC_WRITE_FAILED   4   //!< No se pudo reescribir la pgina corregida.
+//! @}
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Pginas de una zona protegida.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t startPage;     //!< Primera pgina de la zona.
+    uint16_t pageCount;     //!< Pginas de la zona, cero si no est configurada.
+} M24LC512_EccRange;
+
+//*****************************************************************************
+//! \details Zonas y contadores, guardados en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    M24LC512_EccRange range[M24LC512_ECC_RANGES];
+    uint16_t corrected;     //!< Palabras corregidas.
+    uint16_t uncorrectable; //!< Palabras con errores que no se pudieron corregir.
+} M24LC512_EccState;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura una zona protegida.
+//!
+//! \details \b Descripcin \n
+//!          Las pginas se reservan como \b M24LC512_ZONE_ECC + \b Range
+//!          con \a M24LC512_reserveZone(). Cada pgina
+//!          guarda \b M24LC512_ECC_PAGE_WORDS palabras de cdigo, es decir
+//!          \b M24LC512_ECC_PAGE_DATA bytes de datos. Una zona sin escribir
+//!          (0xFF) no es una palabra vlida: se escribe antes de leerla.
+//!
+//! \param Range Nmero de zona, menor a \b M24LC512_ECC_RANGES.
+//! \param StartPage Primera pgina de la zona.
+//! \param PageCount Pginas de la zona, cero para deshabilitarla.
+//!
+//! \return \c true si la zona entra antes de las pginas de reserva y no se
+//!         superpone con una particin ni con otra zona.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_eccInit(const uint8_t Range, const uint16_t StartPage,
+                      const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Devuelve la cantidad de datos que entra en una zona.
+//!
+//! \param Range Nmero de zona.
+//!
+//! \return Bytes de datos, cero si la zona no est configurada.
+//*****************************************************************************
+uint16_t M24LC512_eccCapacity(const uint8_t Range);
+
+//*****************************************************************************
+//! \brief Escribe datos en una zona protegida.
+//!
+//! \details \b Descripcin \n
+//!          Calcula el byte de control de cada palabra y escribe las
+//!          palabras de cada pgina en una sola transaccin. Las palabras
+//!          que se escriben en parte se leen y corrigen antes; si una tiene
+//!          errores que no se pueden corregir la escritura se detiene antes
+//!          de esa pgina, sin volver a codificarla. Por eso la primera
+//!          escritura de una zona nueva (0xFF) debe cubrir palabras
+//!          completas.
+//!
+//! \param Range Nmero de zona.
+//! \param Offset Posicin de los datos dentro de la zona.
+//! \param *Data Datos.
+//! \param Size Cantidad de datos.
+//!
+//! \return \c true si se escribieron los datos, \c false tambin si una
+//!         palabra de los extremos no se pudo corregir.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_eccWrite(const uint8_t Range, uint16_t Offset,
+                       const uint8_t *Data, uint16_t Size);
+
+//*****************************************************************************
+//! \brief Lee datos de una zona protegida y corrige los errores.
+//!
+//! \details \b Descripcin \n
+//!          Lee las palabras de cada pgina en una sola lectura secuencial.
+//!          Un bit cambiado en una palabra se corrige en los datos
+//!          devueltos (la memoria no se reescribe) y se cuenta en
+//!          \b corrected; dos bits se cuentan en \b uncorrectable y se
+//!          devuelven los datos ledos.
+//!
+//! \param Range Nmero de zona.
+//! \param Offset Posicin de los datos dentro de la zona.
+//! \param *Data Buffer donde se guardan los datos ledos.
+//! \param Size Cantidad de datos.
+//!
+//! \return \b M24LC512_ECC_OK, \b M24LC512_ECC_CORRECTED,
+//!         \b M24LC512_ECC_UNCORRECTABLE o \b M24LC512_ECC_INVALID.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+uint8_t M24LC512_eccRead(const uint8_t Range, uint16_t Offset,
+                         uint8_t *Data, uint16_t Size);
+
+//*****************************************************************************
+//! \brief Revisa una pgina de una zona y reescribe las palabras corregidas.
+//!
+//! \details \b Descripcin \n
+//!          Pensada para el repaso peridico de la memoria: si alguna
+//!          palabra tena un bit cambiado, la pgina se reescribe corregida
+//!          antes de que se le sume un segundo error.
+//!
+//! \param Range Nmero de zona.
+//! \param Page Pgina dentro de la zona.
+//!
+//! \return Peor resultado de las palabras de la pgina,
+//!         \b M24LC512_ECC_WRITE_FAILED si fall la reescritura o
+//!         \b M24LC512_ECC_INVALID.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+uint8_t M24LC512_eccScrubPage(const uint8_t Range, const uint16_t Page);
+
+//*****************************************************************************
+//! \brief Devuelve los contadores de palabras corregidas y sin corregir.
+//!
+//! \param *Corrected Devuelve las palabras corregidas.
+//! \param *Uncorrectable Devuelve las palabras que no se pudieron corregir.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_eccStats(uint16_t *Corrected, uint16_t *Uncorrectable);
+
+//*****************************************************************************
+//! \brief Pone en cero los contadores.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+void M24LC512_eccClearStats(void);
+
+#endif /* ECC_H_ */
@@ -0,0 +1,327 @@
+/*
+ * file.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// file.c - Tabla de archivos con nombre en la memoria 24LC512.
+//
+//*****************************************************************************
+
+#include <string.h>
+
+#include "file.h"
+#include "workbuf.h"
+
+// La copia de la tabla se guarda en la FRAM principal: abrir un archivo no usa el bus.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(fileTable)
+static M24LC512_FileTable fileTable = {0};
+#elif defined(__GNUC__)
+static M24LC512_FileTable fileTable __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+//**********************************************************************************************************************************************************
+static uint32_t M24LC512_fileHash(const char *Name)
+{
+    uint32_t hash = M24LC512_FILE_FNV_BASIS;
+
+    while(*Name != '\0')
+    {
+        hash = (hash ^ (uint8_t)*Name++) * M24LC512_FILE_FNV_PRIME;
+    }
+
+    return (hash == M24LC512_FILE_FREE) ? 1 : hash;
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_fileTableAddress(const uint16_t StartPage)
+{
+    return (StartPage * M24LC512_MAXPAGEWRITE) + sizeof(M24LC512_FileHeader);  // Las entradas siguen al encabezado
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_fileValid(const uint8_t File)
+{
+    return (fileTable.pageCount != 0) && (File < M24LC512_FILE_ENTRIES) &&
+           (fileTable.entry[File].hash != M24LC512_FILE_FREE);
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_fileAddress(const M24LC512_FileEntry *Entry)
+{
+    return Entry->startPage * M24LC512_MAXPAGEWRITE;
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_fileAllocate(const uint16_t Pages)
+{
+    uint16_t candidate = fileTable.startPage + M24LC512_FILE_TABLE_PAGES;
+    uint16_t end = fileTable.startPage + fileTable.pageCount;
+    const M24LC512_FileEntry *entry;
+    uint8_t i;
+
+    // Primer hueco contiguo que alcance: si un archivo se superpone con el candidato se prueba justo despues de el.
+    for(i = 0 ; i < M24LC512_FILE_ENTRIES ; i++)
+    {
+        entry = &fileTable.entry[i];
+
+        if((entry->hash != M24LC512_FILE_FREE) && (candidate < (entry->startPage + entry->pageCount)) &&
+           (entry->startPage < (candidate + Pages)))
+        {
+            candidate = entry->startPage + entry->pageCount;
+            i = (uint8_t)-1;                                    // Se vuelve a revisar la tabla completa
+        }
+    }
+
+    return ((uint32_t)candidate + Pages <= end) ? candidate : 0;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileFormat(const uint16_t StartPage, const uint16_t PageCount)
+{
+    uint8_t state;
+
+    if((PageCount <= M24LC512_FILE_TABLE_PAGES) || !M24LC512_reserveZone(M24LC512_ZONE_FILE, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    memset(fileTable.entry, 0, sizeof(fileTable.entry));
+    fileTable.startPage = StartPage;
+    fileTable.pageCount = PageCount;
+
+    M24LC512_framRestore(state);
+
+    return M24LC512_fileSync();
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileMount(const uint16_t StartPage, const uint16_t PageCount)
+{
+    M24LC512_FileHeader header;
+    uint16_t address;
+    uint16_t remaining;
+    uint16_t pieceSize;
+    uint16_t crc = M24LC512_FILE_CRC_SEED;
+    uint8_t state;
+
+    if((PageCount <= M24LC512_FILE_TABLE_PAGES) ||
+       M24LC512_pagesTaken(M24LC512_PARTITIONS, M24LC512_ZONE_FILE, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    M24LC512_sequentialRead(StartPage * M24LC512_MAXPAGEWRITE, (uint8_t *)&header, sizeof(header));
+
+    if((header.magic != M24LC512_FILE_MAGIC) || (header.startPage != StartPage) || (header.pageCount != PageCount))
+    {
+        return false;                                           // Memoria borrada (0xFF) u otra zona
+    }
+
+    // Se verifica el CRC antes de copiar, asi una tabla daada no pisa la de la FRAM.
+    address = M24LC512_fileTableAddress(StartPage);
+    remaining = sizeof(fileTable.entry);
+
+    while(remaining > 0)
+    {
+        pieceSize = (remaining > M24LC512_FILE_PIECE) ? M24LC512_FILE_PIECE : remaining;
+
+        M24LC512_readRange(address, M24LC512_workBuffer, pieceSize);
+        crc = M24LC512_crcContinue(crc, M24LC512_workBuffer, pieceSize);
+
+        address += pieceSize;
+        remaining -= pieceSize;
+    }
+
+    // La zona se reserva recien con una tabla valida: un montaje fallido no ocupa paginas.
+    if((crc != header.crc) || !M24LC512_reserveZone(M24LC512_ZONE_FILE, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    // La tabla de la EEPROM es una imagen de la de la FRAM: se lee directamente sobre ella.
+    state = M24LC512_framUnlock();
+
+    M24LC512_sequentialRead(M24LC512_fileTableAddress(StartPage), (uint8_t *)fileTable.entry, sizeof(fileTable.entry));
+    fileTable.startPage = StartPage;
+    fileTable.pageCount = PageCount;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_fileOpen(const char *Name, const uint16_t Pages)
+{
+    uint32_t hash = M24LC512_fileHash(Name);
+    M24LC512_FileEntry *entry;
+    uint16_t start;
+    uint8_t slot = M24LC512_FILE_NONE;
+    uint8_t state;
+    uint8_t i;
+
+    if(fileTable.pageCount == 0)
+    {
+        return M24LC512_FILE_NONE;
+    }
+
+    for(i = 0 ; i < M24LC512_FILE_ENTRIES ; i++)
+    {
+        if(fileTable.entry[i].hash == hash)
+        {
+            return i;
+        }
+
+        if((fileTable.entry[i].hash == M24LC512_FILE_FREE) && (slot == M24LC512_FILE_NONE))
+        {
+            slot = i;
+        }
+    }
+
+    if((Pages == 0) || (slot == M24LC512_FILE_NONE))
+    {
+        return M24LC512_FILE_NONE;
+    }
+
+    start = M24LC512_fileAllocate(Pages);
+    if(start == 0)
+    {
+        return M24LC512_FILE_NONE;
+    }
+
+    state = M24LC512_framUnlock();
+
+    entry = &fileTable.entry[slot];
+    entry->startPage = start;
+    entry->pageCount = Pages;
+    entry->length = 0;
+    entry->crc = M24LC512_FILE_CRC_SEED;
+    entry->reserved = 0;
+    entry->hash = hash;                                         // El hash al final: la entrada queda completa
+
+    M24LC512_framRestore(state);
+
+    M24LC512_fileSync();
+
+    return slot;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileAppend(const uint8_t File, const uint8_t *Data, const uint16_t Size)
+{
+    M24LC512_FileEntry *entry = &fileTable.entry[File];
+    uint16_t crc;
+    uint8_t state;
+
+    if(!M24LC512_fileValid(File) || (Size == 0) ||
+       (((uint32_t)entry->length + Size) > ((uint32_t)entry->pageCount * M24LC512_MAXPAGEWRITE)))
+    {
+        return false;
+    }
+
+    // Si la escritura fallo la entrada no cambia: el archivo sigue terminando en los ultimos datos buenos.
+    if(!M24LC512_rangeProgram(M24LC512_fileAddress(entry) + entry->length, Data, Size))
+    {
+        return false;
+    }
+
+    crc = M24LC512_crcContinue(entry->crc, Data, Size);
+
+    state = M24LC512_framUnlock();
+
+    entry->crc = crc;
+    entry->length += Size;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileRead(const uint8_t File, const uint16_t Offset, uint8_t *Data, const uint16_t Size)
+{
+    const M24LC512_FileEntry *entry = &fileTable.entry[File];
+
+    if(!M24LC512_fileValid(File) || (Size == 0) || (Offset > entry->length) || (Size > (entry->length - Offset)))
+    {
+        return false;
+    }
+
+    M24LC512_readRange(M24LC512_fileAddress(entry) + Offset, Data, Size);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_fileLength(const uint8_t File)
+{
+    return M24LC512_fileValid(File) ? fileTable.entry[File].length : 0;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileDelete(const uint8_t File)
+{
+    uint8_t state;
+
+    if(!M24LC512_fileValid(File))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+    fileTable.entry[File].hash = M24LC512_FILE_FREE;
+    M24LC512_framRestore(state);
+
+    return M24LC512_fileSync();
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileVerify(const uint8_t File)
+{
+    const M24LC512_FileEntry *entry = &fileTable.entry[File];
+    uint16_t address;
+    uint16_t remaining;
+    uint16_t pieceSize;
+    uint16_t crc = M24LC512_FILE_CRC_SEED;
+
+    if(!M24LC512_fileValid(File))
+    {
+        return false;
+    }
+
+    address = M24LC512_fileAddress(entry);
+    remaining = entry->length;
+
+    while(remaining > 0)
+    {
+        pieceSize = (remaining > M24LC512_FILE_PIECE) ? M24LC512_FILE_PIECE : remaining;
+
+        M24LC512_readRange(address, M24LC512_workBuffer, pieceSize);
+        crc = M24LC512_crcContinue(crc, M24LC512_workBuffer, pieceSize);
+
+        address += pieceSize;
+        remaining -= pieceSize;
+    }
+
+    return (crc == entry->crc);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_fileSync(void)
+{
+    M24LC512_FileHeader header = {0};
+
+    if(fileTable.pageCount == 0)
+    {
+        return false;
+    }
+
+    header.magic = M24LC512_FILE_MAGIC;
+    header.startPage = fileTable.startPage;
+    header.pageCount = fileTable.pageCount;
+    header.crc = M24LC512_crcContinue(M24LC512_FILE_CRC_SEED, (const uint8_t *)fileTable.entry, sizeof(fileTable.entry));
+
+    // El encabezado va al final: hasta que se escribe, el CRC no coincide y la tabla a medio escribir no se monta.
+    if(!M24LC512_rangeProgram(M24LC512_fileTableAddress(fileTable.startPage), (const uint8_t *)fileTable.entry,
+                             sizeof(fileTable.entry)))
+    {
+        return false;
+    }
+
+    return M24LC512_rangeProgram(fileTable.startPage * M24LC512_MAXPAGEWRITE, (const uint8_t *)&header, sizeof(header));
+}
@@ -0,0 +1,264 @@
+/**
+  * @file     file.h
+  * @brief    Tabla de archivos con nombre en la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// file.h - Tabla de archivos con nombre en la memoria 24LC512.
+//
+//*****************************************************************************
+
+#ifndef FILE_H_
+#define FILE_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "partition.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Cantidad mxima de archivos. El encabezado de la tabla ocupa el
+//!          lugar de una entrada ms.
+//*****************************************************************************
+#define M24LC512_FILE_ENTRIES       31
+
+//*****************************************************************************
+//! \details Tamao de cada entrada de la tabla. Entra un nmero entero de
+//!          entradas por pgina.
+//*****************************************************************************
+#define M24LC512_FILE_ENTRY_SIZE    16
+
+//*****************************************************************************
+//! \details Pginas que ocupa la tabla al comienzo de la zona.
+//*****************************************************************************
+#define M24LC512_FILE_TABLE_PAGES   (((M24LC512_FILE_ENTRIES + 1) * M24LC512_FILE_ENTRY_SIZE) / M24LC512_MAXPAGEWRITE)
+
+//*****************************************************************************
+//! \details Identificador del encabezado de una tabla de archivos vlida.
+//*****************************************************************************
+#define M24LC512_FILE_MAGIC         0x46494C45UL
+
+//*****************************************************************************
+//! \details Valor devuelto por \a M24LC512_fileOpen() si no hay archivo.
+//*****************************************************************************
+#define M24LC512_FILE_NONE          0xFF
+
+//*****************************************************************************
+//! \details Hash de una entrada libre. Ningn nombre tiene este hash.
+//*****************************************************************************
+#define M24LC512_FILE_FREE          0x00000000UL
+
+//*****************************************************************************
+//! \details Semilla y primo del hash FNV-1a de 32 bits de los nombres.
+//*****************************************************************************
+//! @name Hash de los nombres
+//! @{
+#define M24LC512_FILE_FNV_BASIS     0x811C9DC5UL
+#define M24LC512_FILE_FNV_PRIME     0x01000193UL
+//! @}
+
+//*****************************************************************************
+//! \details Semilla del CRC16 del contenido de cada archivo.
+//*****************************************************************************
+#define M24LC512_FILE_CRC_SEED      0xFFFF
+
+//*****************************************************************************
+//! \details Bytes que se leen por transaccin al verificar un archivo.
+//*****************************************************************************
+#define M24LC512_FILE_PIECE         32
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Entrada de la tabla de archivos.
+//*****************************************************************************
+typedef struct
+{
+    uint32_t hash;          //!< Hash del nombre o \b M24LC512_FILE_FREE.
+    uint16_t startPage;     //!< Primera pgina del archivo.
+    uint16_t pageCount;     //!< Pginas reservadas.
+    uint16_t length;        //!< Bytes escritos.
+    uint16_t crc;           //!< CRC16 de los bytes escritos.
+    uint32_t reserved;
+} M24LC512_FileEntry;
+
+_Static_assert(sizeof(M24LC512_FileEntry) == M24LC512_FILE_ENTRY_SIZE, "M24LC512_FileEntry con relleno");
+
+//*****************************************************************************
+//! \details Encabezado de la tabla en la EEPROM, antes de las entradas.
+//*****************************************************************************
+typedef struct
+{
+    uint32_t magic;         //!< \b M24LC512_FILE_MAGIC.
+    uint16_t startPage;     //!< Primera pgina de la zona.
+    uint16_t pageCount;     //!< Pginas de la zona.
+    uint16_t crc;           //!< CRC16 de las entradas.
+    uint16_t reserved[3];
+} M24LC512_FileHeader;
+
+_Static_assert(sizeof(M24LC512_FileHeader) == M24LC512_FILE_ENTRY_SIZE, "M24LC512_FileHeader con relleno");
+
+//*****************************************************************************
+//! \details Copia de la tabla en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t startPage;     //!< Primera pgina de la zona (tabla incluida).
+    uint16_t pageCount;     //!< Pginas de la zona, cero si no est montada.
+    M24LC512_FileEntry entry[M24LC512_FILE_ENTRIES];
+} M24LC512_FileTable;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Crea una tabla de archivos vaca.
+//!
+//! \details \b Descripcin \n
+//!          La zona ocupa \b PageCount pginas desde \b StartPage, que se
+//!          reservan como \b M24LC512_ZONE_FILE con
+//!          \a M24LC512_reserveZone(); la tabla ocupa sus primeras
+//!          \b M24LC512_FILE_TABLE_PAGES pginas. Borra todos los archivos.
+//!
+//! \param StartPage Primera pgina de la zona.
+//! \param PageCount Pginas de la zona.
+//!
+//! \return \c true si la zona entra antes de las pginas de reserva y no se
+//!         superpone con una particin ni con otra zona.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_fileFormat(const uint16_t StartPage, const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Carga la tabla de la EEPROM en la FRAM.
+//!
+//! \details \b Descripcin \n
+//!          La copia de la FRAM sobrevive a un reset, as que solo hace
+//!          falta montar si se perdi (por ejemplo al cargar otro firmware).
+//!          Se recuperan los archivos hasta el ltimo
+//!          \a M24LC512_fileSync(). La tabla se copia en la FRAM solo si el
+//!          encabezado tiene \b M24LC512_FILE_MAGIC, la misma zona y el CRC
+//!          de las entradas coincide; una memoria borrada no se monta. Solo
+//!          entonces se reserva la zona como \b M24LC512_ZONE_FILE.
+//!
+//! \param StartPage Primera pgina de la zona.
+//! \param PageCount Pginas de la zona.
+//!
+//! \return \c true si la zona est libre y la tabla de la EEPROM es
+//!         vlida.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE, \b SYSCFG0,
+//!            \b CRCINIRES y \b CRCDI.
+//*****************************************************************************
+bool M24LC512_fileMount(const uint16_t StartPage, const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Abre un archivo y lo crea si no existe.
+//!
+//! \details \b Descripcin \n
+//!          Busca el hash del nombre en la copia de la FRAM, sin usar el
+//!          bus. Si no existe y \b Pages no es cero, reserva esa cantidad de
+//!          pginas contiguas libres y guarda la tabla.
+//!
+//! \param *Name Nombre del archivo, terminado en cero.
+//! \param Pages Pginas a reservar al crearlo, o cero para solo abrir.
+//!
+//! \return Nmero de archivo o \b M24LC512_FILE_NONE.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+uint8_t M24LC512_fileOpen(const char *Name, const uint16_t Pages);
+
+//*****************************************************************************
+//! \brief Agrega datos al final de un archivo.
+//!
+//! \details \b Descripcin \n
+//!          Escribe por pginas, sin sello, y si la escritura no fall
+//!          actualiza la longitud y el CRC en la FRAM. La tabla de la EEPROM se actualiza con
+//!          \a M24LC512_fileSync().
+//!
+//! \param File Nmero de archivo.
+//! \param *Data Datos.
+//! \param Size Cantidad de datos, sin pasar las pginas reservadas.
+//!
+//! \return \c true si se escribieron los datos.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_fileAppend(const uint8_t File, const uint8_t *Data,
+                         const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Lee parte de un archivo.
+//!
+//! \details \b Descripcin \n
+//!          Las pginas de un archivo son contiguas, as que cualquier rango
+//!          se lee en una sola lectura secuencial, sin importar su tamao.
+//!
+//! \param File Nmero de archivo.
+//! \param Offset Posicin dentro del archivo.
+//! \param *Data Buffer donde se guardan los datos ledos.
+//! \param Size Cantidad de datos.
+//!
+//! \return \c false si el rango se pasa del archivo.
+//*****************************************************************************
+bool M24LC512_fileRead(const uint8_t File, const uint16_t Offset,
+                       uint8_t *Data, const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Devuelve la longitud de un archivo.
+//!
+//! \param File Nmero de archivo.
+//!
+//! \return Bytes escritos, cero si el archivo no existe.
+//*****************************************************************************
+uint16_t M24LC512_fileLength(const uint8_t File);
+
+//*****************************************************************************
+//! \brief Borra un archivo y libera sus pginas.
+//!
+//! \param File Nmero de archivo.
+//!
+//! \return \c true si el archivo exista.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_fileDelete(const uint8_t File);
+
+//*****************************************************************************
+//! \brief Verifica el CRC de un archivo.
+//!
+//! \param File Nmero de archivo.
+//!
+//! \return \c true si el contenido coincide con el CRC de la tabla.
+//*****************************************************************************
+bool M24LC512_fileVerify(const uint8_t File);
+
+//*****************************************************************************
+//! \brief Guarda la copia de la FRAM en la tabla de la EEPROM.
+//!
+//! \details \b Descripcin \n
+//!          Escribe primero las entradas y por ltimo el encabezado con su
+//!          CRC: un reset en el medio deja una tabla que no se monta.
+//!
+//! \return \c true si se escribi la tabla.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE, \b CRCINIRES y \b CRCDI.
+//*****************************************************************************
+bool M24LC512_fileSync(void);
+
+#endif /* FILE_H_ */
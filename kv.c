@@ -0,0 +1,309 @@
+/*
+ * kv.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// kv.c - Almacn de pares clave-valor con ndice en la FRAM.
+//
+//*****************************************************************************
+
+#include <string.h>
+
+#include "kv.h"
+#include "workbuf.h"
+
+// El indice se guarda en la FRAM principal para que las lecturas nunca tengan que recorrer la EEPROM.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(kv)
+static M24LC512_KvStore kv = {0};
+#elif defined(__GNUC__)
+static M24LC512_KvStore kv __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_kvHome(const uint16_t Key)
+{
+    // Hash multiplicativo: los bits altos del producto reparten bien las claves consecutivas.
+    return (uint16_t)(Key * M24LC512_KV_HASH) >> (16 - M24LC512_KV_SLOT_BITS);
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_kvFind(const uint16_t Key)
+{
+    uint16_t slot = M24LC512_kvHome(Key);
+
+    // Sondeo lineal: siempre queda un lugar vacio que corta la busqueda.
+    while((kv.entry[slot].key != M24LC512_KV_EMPTY) && (kv.entry[slot].key != Key))
+    {
+        slot = (slot + 1) & (M24LC512_KV_SLOTS - 1);
+    }
+
+    return slot;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_kvSet(const uint16_t Key, const uint16_t Address, const uint16_t Sequence, const uint8_t Length)
+{
+    uint16_t slot = M24LC512_kvFind(Key);
+    M24LC512_KvEntry *entry = &kv.entry[slot];
+    uint8_t state;
+
+    if((entry->key == M24LC512_KV_EMPTY) && (kv.count >= M24LC512_KV_KEYS))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    entry->address = Address;
+    entry->sequence = Sequence;
+    entry->length = Length;
+    if(entry->key == M24LC512_KV_EMPTY)
+    {
+        entry->key = Key;                                       // La clave al final: la entrada queda completa
+        kv.count++;
+    }
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_kvRemove(uint16_t Slot)
+{
+    uint16_t next = Slot;
+    uint16_t home;
+    uint8_t state;
+
+    state = M24LC512_framUnlock();
+
+    // Borrado con corrimiento hacia atras: las entradas siguientes del mismo grupo ocupan el hueco y no hacen falta
+    // marcas de borrado. Se mueve una entrada si su lugar ideal no queda entre el hueco y ella.
+    for(;;)
+    {
+        next = (next + 1) & (M24LC512_KV_SLOTS - 1);
+        if(kv.entry[next].key == M24LC512_KV_EMPTY)
+        {
+            break;
+        }
+
+        home = M24LC512_kvHome(kv.entry[next].key);
+        if(((next - home) & (M24LC512_KV_SLOTS - 1)) >= ((next - Slot) & (M24LC512_KV_SLOTS - 1)))
+        {
+            kv.entry[Slot] = kv.entry[next];
+            Slot = next;
+        }
+    }
+
+    kv.entry[Slot].key = M24LC512_KV_EMPTY;
+    kv.count--;
+
+    M24LC512_framRestore(state);
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_kvAppend(const uint16_t Key, const uint8_t *Value, const uint8_t Length)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(kv.partition);
+    uint8_t prefix[M24LC512_KV_KEY_SIZE];
+    uint16_t sequence = part->nextSequence;
+    uint16_t address;
+
+    prefix[0] = (uint8_t)(Key >> 8);
+    prefix[1] = (uint8_t)Key;
+
+    // Si falla la escritura el indice sigue apuntando al valor anterior.
+    if(!M24LC512_recordAppendPrefixed(kv.partition, prefix, M24LC512_KV_KEY_SIZE, Value, Length, &address))
+    {
+        return false;
+    }
+
+    if(Length == 0)
+    {
+        M24LC512_kvRemove(M24LC512_kvFind(Key));
+        return true;
+    }
+
+    return M24LC512_kvSet(Key, address, sequence, Length);
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_kvFreePages(const M24LC512_Partition *Part)
+{
+    uint16_t head = (Part->head - M24LC512_partitionStart(Part)) / M24LC512_MAXPAGEWRITE;
+    uint16_t oldest = (Part->oldest - M24LC512_partitionStart(Part)) / M24LC512_MAXPAGEWRITE;
+
+    if(Part->oldestSequence == Part->nextSequence)
+    {
+        return Part->pageCount;
+    }
+
+    // Paginas entre la que se esta escribiendo y la mas vieja, sin contar ninguna de las dos.
+    return (oldest + Part->pageCount - head - 1) % Part->pageCount;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_kvInit(const uint8_t Id)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+    M24LC512_RecordIterator iterator;
+    uint16_t address;
+    uint16_t key;
+    uint8_t length;
+    uint8_t state;
+
+    if((part == 0) || (part->pageCount <= M24LC512_KV_RESERVE_PAGES))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    kv.partition = Id;
+    kv.enabled = 1;
+    kv.count = 0;
+    memset(kv.entry, 0, sizeof(kv.entry));
+
+    M24LC512_framRestore(state);
+
+    M24LC512_recordBegin(Id, &iterator);
+
+    // Del registro mas viejo al mas nuevo: el ultimo valor de cada clave es el que queda en el indice.
+    while(M24LC512_recordNext(&iterator, M24LC512_workBuffer, &length))
+    {
+        if(length < M24LC512_KV_KEY_SIZE)
+        {
+            continue;
+        }
+
+        key = ((uint16_t)M24LC512_workBuffer[0] << 8) | M24LC512_workBuffer[1];
+        if(key == M24LC512_KV_EMPTY)
+        {
+            continue;
+        }
+
+        // El iterador ya apunta al registro siguiente, que vuelve al inicio si este termino justo en el final.
+        address = (iterator.address == M24LC512_partitionStart(part)) ? M24LC512_partitionEnd(part) : iterator.address;
+        address -= M24LC512_RECORD_FRAME_SIZE + length;
+
+        if(length == M24LC512_KV_KEY_SIZE)
+        {
+            if(kv.entry[M24LC512_kvFind(key)].key == key)
+            {
+                M24LC512_kvRemove(M24LC512_kvFind(key));
+            }
+        }
+        else
+        {
+            M24LC512_kvSet(key, address, iterator.sequence - 1, length - M24LC512_KV_KEY_SIZE);
+        }
+    }
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_kvPut(const uint16_t Key, const uint8_t *Value, const uint8_t Length)
+{
+    const M24LC512_Partition *part;
+    uint16_t i;
+
+    if(!kv.enabled || (Key == M24LC512_KV_EMPTY) || (Length == 0) || (Length > M24LC512_KV_VALUE_MAX) ||
+       ((kv.entry[M24LC512_kvFind(Key)].key == M24LC512_KV_EMPTY) && (kv.count >= M24LC512_KV_KEYS)))
+    {
+        return false;
+    }
+
+    // Se libera lugar antes de que la escritura descarte la pagina mas vieja con valores vigentes. El limite evita un
+    // lazo sin fin si los valores vigentes no entran en la particion.
+    part = M24LC512_getPartition(kv.partition);
+    for(i = 0 ; (i < part->pageCount) && (M24LC512_kvFreePages(part) < M24LC512_KV_RESERVE_PAGES) ; i++)
+    {
+        if(M24LC512_kvCompact() == M24LC512_KV_FAILED)
+        {
+            return false;
+        }
+    }
+
+    return M24LC512_kvAppend(Key, Value, Length);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_kvGet(const uint16_t Key, uint8_t *Value, uint8_t *Length)
+{
+    const M24LC512_KvEntry *entry = &kv.entry[M24LC512_kvFind(Key)];
+
+    if(!kv.enabled || (Key == M24LC512_KV_EMPTY) || (entry->key != Key))
+    {
+        return false;
+    }
+
+    if(!M24LC512_recordFetch(kv.partition, entry->address, entry->sequence, M24LC512_workBuffer,
+                             M24LC512_KV_KEY_SIZE + entry->length) ||
+       ((((uint16_t)M24LC512_workBuffer[0] << 8) | M24LC512_workBuffer[1]) != Key))
+    {
+        return false;
+    }
+
+    memcpy(Value, &M24LC512_workBuffer[M24LC512_KV_KEY_SIZE], entry->length);
+    *Length = entry->length;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_kvDelete(const uint16_t Key)
+{
+    if(!kv.enabled || (Key == M24LC512_KV_EMPTY) || (kv.entry[M24LC512_kvFind(Key)].key != Key))
+    {
+        return false;
+    }
+
+    return M24LC512_kvAppend(Key, 0, 0);
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_kvCompact(void)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(kv.partition);
+    M24LC512_KvEntry *entry;
+    uint16_t page;
+    uint16_t moved = 0;
+    uint16_t slot = 0;
+
+    if(!kv.enabled || (part == 0) || (part->oldestSequence == part->nextSequence) ||
+       ((part->oldest / M24LC512_MAXPAGEWRITE) == (part->head / M24LC512_MAXPAGEWRITE)))
+    {
+        return 0;
+    }
+
+    page = part->oldest / M24LC512_MAXPAGEWRITE;
+
+    // Los valores vigentes de la pagina mas vieja se vuelven a escribir al final.
+    while(slot < M24LC512_KV_SLOTS)
+    {
+        entry = &kv.entry[slot];
+
+        if((entry->key != M24LC512_KV_EMPTY) && ((entry->address / M24LC512_MAXPAGEWRITE) == page))
+        {
+            if(M24LC512_recordFetch(kv.partition, entry->address, entry->sequence, M24LC512_workBuffer,
+                                    M24LC512_KV_KEY_SIZE + entry->length))
+            {
+                // Si no se pudo mover un valor la pagina todavia tiene datos vigentes y no se descarta.
+                if(!M24LC512_kvAppend(entry->key, &M24LC512_workBuffer[M24LC512_KV_KEY_SIZE], entry->length))
+                {
+                    return M24LC512_KV_FAILED;
+                }
+                moved++;
+            }
+            else
+            {
+                M24LC512_kvRemove(slot);                        // Ilegible: el corrimiento trae otra entrada a este lugar
+                continue;
+            }
+        }
+
+        slot++;
+    }
+
+    // Ya no queda nada vigente en la pagina: se descartan sus registros.
+    M24LC512_recordTrimPage(kv.partition);
+
+    return moved;
+}
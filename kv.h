@@ -0,0 +1,199 @@
+/**
+  * @file     kv.h
+  * @brief    Almacn de pares clave-valor con ndice en la FRAM.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// kv.h - Almacn de pares clave-valor con ndice en la FRAM.
+//
+//*****************************************************************************
+
+#ifndef KV_H_
+#define KV_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "record.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Bits del ndice: la tabla tiene 2^\b M24LC512_KV_SLOT_BITS
+//!          lugares.
+//*****************************************************************************
+#define M24LC512_KV_SLOT_BITS       6
+
+//*****************************************************************************
+//! \details Lugares de la tabla del ndice.
+//*****************************************************************************
+#define M24LC512_KV_SLOTS           (1 << M24LC512_KV_SLOT_BITS)
+
+//*****************************************************************************
+//! \details Cantidad mxima de claves. Siempre queda un lugar vaco para que
+//!          el sondeo lineal termine.
+//*****************************************************************************
+#define M24LC512_KV_KEYS            (M24LC512_KV_SLOTS - 1)
+
+//*****************************************************************************
+//! \details Constante del hash multiplicativo de las claves (2^16 / phi).
+//*****************************************************************************
+#define M24LC512_KV_HASH            40503U
+
+//*****************************************************************************
+//! \details Clave de un lugar vaco del ndice. No se puede usar como clave.
+//*****************************************************************************
+#define M24LC512_KV_EMPTY           0x0000
+
+//*****************************************************************************
+//! \details Tamao de la clave al comienzo de cada registro.
+//*****************************************************************************
+#define M24LC512_KV_KEY_SIZE        2
+
+//*****************************************************************************
+//! \details Tamao mximo de un valor.
+//*****************************************************************************
+#define M24LC512_KV_VALUE_MAX       32
+
+//*****************************************************************************
+//! \details Pginas libres que se mantienen delante del puntero de escritura.
+//!          Si quedan menos se compacta antes de escribir; alcanzan para
+//!          mover las claves vigentes de la pgina ms vieja.
+//*****************************************************************************
+#define M24LC512_KV_RESERVE_PAGES   3
+
+//*****************************************************************************
+//! \details Resultado de \a M24LC512_kvCompact() cuando no se pudo volver a
+//!          escribir un valor vigente.
+//*****************************************************************************
+#define M24LC512_KV_FAILED          0xFFFF
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Lugar del ndice: dnde est el ltimo valor de una clave.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t key;           //!< Clave o \b M24LC512_KV_EMPTY.
+    uint16_t address;       //!< Direccin del registro.
+    uint16_t sequence;      //!< Nmero de secuencia del registro.
+    uint8_t length;         //!< Tamao del valor.
+    uint8_t reserved;
+} M24LC512_KvEntry;
+
+//*****************************************************************************
+//! \details ndice del almacn, guardado en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint8_t partition;      //!< Particin del registro de valores.
+    uint8_t enabled;        //!< Distinto de cero si est configurado.
+    uint16_t count;         //!< Claves en el ndice.
+    M24LC512_KvEntry entry[M24LC512_KV_SLOTS];
+} M24LC512_KvStore;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura el almacn y reconstruye su ndice.
+//!
+//! \details \b Descripcin \n
+//!          Los valores se guardan como registros de la particin \b Id,
+//!          cada uno con la clave como prefijo. Recorre la particin desde el
+//!          registro ms viejo y deja en el ndice el ltimo valor de cada
+//!          clave. El ndice queda en la FRAM, as que solo hace falta
+//!          llamarla al configurar la particin o si un reset cort una
+//!          escritura despus de guardar el registro y antes de actualizar
+//!          el ndice.
+//!
+//! \param Id Nmero de particin, de ms de \b M24LC512_KV_RESERVE_PAGES
+//!        pginas.
+//!
+//! \return \c true si la particin es vlida.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_kvInit(const uint8_t Id);
+
+//*****************************************************************************
+//! \brief Guarda el valor de una clave.
+//!
+//! \details \b Descripcin \n
+//!          Agrega un registro nuevo al final de la particin y actualiza el
+//!          ndice; el valor anterior queda obsoleto. Como cada escritura
+//!          cae en la pgina siguiente del registro circular, las
+//!          actualizaciones frecuentes se reparten por toda la particin.
+//!          Si quedan menos de \b M24LC512_KV_RESERVE_PAGES pginas libres
+//!          primero se compacta con \a M24LC512_kvCompact(); si la
+//!          compactacin falla no se guarda el valor.
+//!
+//! \param Key Clave, distinta de \b M24LC512_KV_EMPTY.
+//! \param *Value Valor.
+//! \param Length Tamao del valor, de 1 a \b M24LC512_KV_VALUE_MAX.
+//!
+//! \return \c true si se guard el valor, \c false tambin si fall la
+//!         compactacin previa.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_kvPut(const uint16_t Key, const uint8_t *Value,
+                    const uint8_t Length);
+
+//*****************************************************************************
+//! \brief Lee el valor de una clave.
+//!
+//! \details \b Descripcin \n
+//!          Busca la clave en el ndice de la FRAM y lee el registro con
+//!          \a M24LC512_recordFetch(), en una sola transaccin.
+//!
+//! \param Key Clave.
+//! \param *Value Buffer de \b M24LC512_KV_VALUE_MAX bytes.
+//! \param *Length Devuelve el tamao del valor.
+//!
+//! \return \c false si la clave no existe o el registro no es vlido.
+//*****************************************************************************
+bool M24LC512_kvGet(const uint16_t Key, uint8_t *Value, uint8_t *Length);
+
+//*****************************************************************************
+//! \brief Borra una clave.
+//!
+//! \details \b Descripcin \n
+//!          Agrega un registro con la clave y sin valor, para que la
+//!          reconstruccin del ndice tambin la descarte.
+//!
+//! \param Key Clave.
+//!
+//! \return \c true si la clave exista.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_kvDelete(const uint16_t Key);
+
+//*****************************************************************************
+//! \brief Libera la pgina ms vieja del almacn.
+//!
+//! \details \b Descripcin \n
+//!          Vuelve a escribir al final de la particin los valores vigentes
+//!          que estn en la pgina ms vieja y descarta sus registros, que
+//!          quedan todos obsoletos. Si falla la escritura de un valor se
+//!          detiene sin descartar la pgina, as ningn valor vigente se
+//!          pierde; los que ya se movieron quedan en su copia nueva.
+//!
+//! \return Cantidad de valores movidos o \b M24LC512_KV_FAILED.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+uint16_t M24LC512_kvCompact(void);
+
+#endif /* KV_H_ */
@@ -13,11 +13,17 @@ int main(void)
 
     WDTCTL = WDTPW + WDTHOLD;                   // Stop watchdog timer
 
+    M24LC512_initClock(M24LC512_CLOCK_PERFORMANCE); // MCLK = SMCLK = 16 MHz, SCL = 400 KHz
+
     M24LC512_initPort();                        // Initialize I2C module
 
     // Desabilita el modo de alta impedancia habilitando la configuracin establecida previamente.
     PM5CTL0 &= ~LOCKLPM5;
 
+    M24LC512_measureWakeupCost();               // Costo de salida de LPM0/LPM3 para la politica automatica
+
+    M24LC512_loadHeader();                      // Cabecera de la memoria desde la FRAM
+
     M24LC512_byteWrite(0xF9FF,0x85);
     M24LC512_ackPolling();                      // Wait for EEPROM write cycle
                                                 // completion
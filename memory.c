@@ -10,10 +10,60 @@
 //
 //*****************************************************************************
 
+#include <stddef.h>
+#include <string.h>
+
 #include "memory.h"
+#include "workbuf.h"
 //*****************************************************************************
 uint16_t countS;
 uint8_t *myArray;
+M24LC512_Header M24LC512_header;
+uint8_t M24LC512_workBuffer[M24LC512_MAXPAGEWRITE];
+
+static uint8_t activeSlot;                                      // Copia de la cabecera en FRAM que esta vigente
+
+static uint16_t smclkKHz = M24LC512_DEFAULT_SMCLK_KHZ;         // Frecuencia de SMCLK del perfil actual
+static uint16_t busDivider = M24LC512_PIN_SCL_CLOCK_DIV;        // Divisor de SCL cargado en UCB0BRW
+
+static uint8_t lpmPolicy = M24LC512_LPM_AUTO;                   // Politica de bajo consumo seleccionada
+static uint16_t lpmBits = LPM3_bits;                            // Bajo consumo usado en la transferencia actual
+static uint16_t wakeupCycles[2];                                // Costo de salida de LPM0 y LPM3 en ciclos de SMCLK
+
+static bool pageStamp = false;                                  // Se antepone el sello de secuencia a cada pagina
+static uint8_t verifyPolicy = M24LC512_VERIFY_NONE;             // Relectura de cada escritura
+static uint8_t verifyRetries = M24LC512_VERIFY_RETRIES;         // Reintentos antes de reubicar la pagina
+static uint8_t writeOutcome = M24LC512_WRITE_OK;                // Peor resultado de la ultima escritura
+static volatile bool writeAbort = false;                        // No se empiezan mas paginas (caida de tension)
+static uint16_t crcStream = 0;                                  // Bytes leidos que todavia se pasan al modulo CRC
+
+// La tabla describe el integrado y no el registro: se guarda en la FRAM principal y no se borra con la cabecera.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(badPages)
+static M24LC512_BadPages badPages = {0};
+#elif defined(__GNUC__)
+static M24LC512_BadPages badPages __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+// Las zonas reservadas por los modulos se guardan junto a la tabla de paginas defectuosas y tampoco se borran con la cabecera.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(zones)
+static M24LC512_Reservation zones[M24LC512_ZONES] = {0};
+#elif defined(__GNUC__)
+static M24LC512_Reservation zones[M24LC512_ZONES] __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+// Los datos a escribir pueden estar en M24LC512_workBuffer, por eso la pagina a reubicar y la relectura tienen sus buffers.
+static uint8_t pageBuffer[M24LC512_MAXPAGEWRITE];
+static uint8_t verifyBuffer[M24LC512_VERIFY_PIECE];
+
+static uint8_t M24LC512_readByte(const uint16_t Address);
+static void M24LC512_readBlock(const uint16_t Address, uint8_t *Data, const uint16_t Size);
+static void M24LC512_storeByte(uint8_t *Data, const uint16_t Index);
 //**********************************************************************************************************************************************************
 void M24LC512_initPort(void)
 {
@@ -24,12 +74,14 @@ void M24LC512_initPort(void)
     UCB0CTLW0 |= UCSWRST;
     UCB0CTLW0 |= UCMST | UCMODE_3 | UCSYNC | UCSSEL__SMCLK;        // I2C mode, master, sync, sending, SMCLK
 
-    UCB0BRW = M24LC512_PIN_SCL_CLOCK_DIV;                          // SMCLK / 10 = 100 KHz; Bit clock prescaler. Modify only when UCSWRST = 1.
+    UCB0BRW = busDivider;                                          // Divisor de SMCLK del perfil de reloj; Bit clock prescaler. Modify only when UCSWRST = 1.
 
     UCB0I2CSA = M24LC512_I2C_ADDRESS;                              // Direccin de la memoria (Esclavo).
 
     UCB0CTLW0 &= ~UCSWRST;                                         // clear reset register
 
+    CS_enableClockRequest(CS_SMCLK);                               // El eUSCI_B mantiene SMCLK activo en LPM3
+
     if (UCB0STAT & UCBBUSY)                                        // test if bus to be free otherwise a manual Clock on is
     {                                                              // generated
         M24LC512_PORT_SEL &= ~M24LC512_PIN_SCL;                    // Select Port function for SCL
@@ -39,6 +91,149 @@ void M24LC512_initPort(void)
     };
 }
 //**********************************************************************************************************************************************************
+static void M24LC512_loadBusDivider(void)
+{
+    if((UCB0CTLW0 & UCMODE_3) == UCMODE_3)                          // Solo si el eUSCI_B ya esta en modo I2C
+    {
+        UCB0CTLW0 |= UCSWRST;
+        UCB0BRW = busDivider;                                       // Modify only when UCSWRST = 1.
+        UCB0CTLW0 &= ~UCSWRST;
+    }
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_initClock(const uint8_t Profile)
+{
+    bool status;
+
+    if(Profile == M24LC512_CLOCK_PERFORMANCE)
+    {
+        // Por encima de 8 MHz la FRAM necesita un estado de espera, se configura antes de subir MCLK.
+        FRAMCtl_configureWaitStateControl(FRAMCTL_ACCESS_TIME_CYCLES_1);
+
+        CS_initClockSignal(CS_FLLREF, CS_REFOCLK_SELECT, CS_CLOCK_DIVIDER_1);
+        CS_initClockSignal(CS_ACLK, CS_REFOCLK_SELECT, CS_CLOCK_DIVIDER_1);
+        status = CS_initFLLSettle(M24LC512_PERFORMANCE_SMCLK_KHZ,
+                                  (uint16_t)((M24LC512_PERFORMANCE_SMCLK_KHZ * 1000UL + M24LC512_FLLREF_HZ / 2) / M24LC512_FLLREF_HZ));
+        CS_initClockSignal(CS_MCLK, CS_DCOCLKDIV_SELECT, CS_CLOCK_DIVIDER_1);
+        CS_initClockSignal(CS_SMCLK, CS_DCOCLKDIV_SELECT, CS_CLOCK_DIVIDER_1);
+
+        smclkKHz = M24LC512_PERFORMANCE_SMCLK_KHZ;
+        M24LC512_setBusSpeed(M24LC512_PERFORMANCE_SCL_KHZ);
+    }
+    else
+    {
+        CS_initClockSignal(CS_FLLREF, CS_REFOCLK_SELECT, CS_CLOCK_DIVIDER_1);
+        status = CS_initFLLSettle(M24LC512_DEFAULT_SMCLK_KHZ,
+                                  (uint16_t)((M24LC512_DEFAULT_SMCLK_KHZ * 1000UL + M24LC512_FLLREF_HZ / 2) / M24LC512_FLLREF_HZ));
+        CS_initClockSignal(CS_MCLK, CS_DCOCLKDIV_SELECT, CS_CLOCK_DIVIDER_1);
+        CS_initClockSignal(CS_SMCLK, CS_DCOCLKDIV_SELECT, CS_CLOCK_DIVIDER_1);
+
+        // Recin con MCLK por debajo de 8 MHz se pueden quitar los estados de espera.
+        if(M24LC512_DEFAULT_SMCLK_KHZ <= M24LC512_FRAM_NOWAIT_MAX_KHZ)
+        {
+            FRAMCtl_configureWaitStateControl(FRAMCTL_ACCESS_TIME_CYCLES_0);
+        }
+
+        smclkKHz = M24LC512_DEFAULT_SMCLK_KHZ;
+        busDivider = M24LC512_PIN_SCL_CLOCK_DIV;
+        M24LC512_loadBusDivider();
+    }
+
+    return status;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_setBusSpeed(const uint16_t SclKHz)
+{
+    uint16_t divider;
+
+    if((SclKHz == 0) || (SclKHz > M24LC512_MAX_SCL_KHZ))
+    {
+        return false;
+    }
+
+    divider = (smclkKHz + SclKHz - 1) / SclKHz;                     // Se redondea hacia arriba para no superar SclKHz
+    if(divider < M24LC512_MIN_SCL_DIVIDER)
+    {
+        divider = M24LC512_MIN_SCL_DIVIDER;
+    }
+
+    busDivider = divider;
+    M24LC512_loadBusDivider();
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_setLowPowerPolicy(const uint8_t Policy)
+{
+    lpmPolicy = Policy;
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_selectLowPowerMode(const uint16_t Size)
+{
+    uint32_t byteCycles;
+    uint16_t extraCycles;
+
+    if(lpmPolicy == M24LC512_LPM_0)
+    {
+        lpmBits = LPM0_bits;
+        return;
+    }
+    if(lpmPolicy == M24LC512_LPM_3)
+    {
+        lpmBits = LPM3_bits;
+        return;
+    }
+
+    // Un byte en el bus son 9 periodos de SCL, es decir 9 * UCB0BRW ciclos de SMCLK.
+    byteCycles = 9UL * busDivider;
+
+    // Ciclos que agrega salir de LPM3 respecto de salir de LPM0.
+    extraCycles = 0;
+    if(wakeupCycles[1] > wakeupCycles[0])
+    {
+        extraCycles = wakeupCycles[1] - wakeupCycles[0];
+    }
+
+    if((Size <= M24LC512_LPM_SHORT_TRANSFER) ||
+       (((uint32_t)extraCycles * M24LC512_LPM_WAKEUP_RATIO) > byteCycles))
+    {
+        lpmBits = LPM0_bits;    // Transferencia corta o bus rapido: la salida de LPM3 estiraria el SCL
+    }
+    else
+    {
+        lpmBits = LPM3_bits;    // Transferencia larga: se aprovecha el ahorro de LPM3
+    }
+}
+//**********************************************************************************************************************************************************
+void M24LC512_measureWakeupCost(void)
+{
+    uint8_t i;
+    uint16_t bits;
+
+    CS_enableClockRequest(CS_SMCLK);                // El Timer_A1 pide SMCLK para seguir contando en LPM3
+
+    TA1CTL = TASSEL__SMCLK | MC__CONTINUOUS | TACLR;
+
+    for(i = 0 ; i < 2 ; i++)
+    {
+        bits = (i == 0) ? LPM0_bits : LPM3_bits;
+
+        TA1CCR0 = TA1R + M24LC512_WAKEUP_PROBE_CYCLES;
+        TA1CCTL0 = CCIE;
+        __bis_SR_register(bits + GIE);              // Se despierta en la interrupcion del CCR0
+
+        wakeupCycles[i] = TA1R - TA1CCR0;           // Ciclos desde el evento hasta volver al programa
+    }
+
+    TA1CCTL0 = 0;
+    TA1CTL = MC__STOP;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_getWakeupCost(const uint8_t Mode)
+{
+    return (Mode == M24LC512_LPM_0) ? wakeupCycles[0] : wakeupCycles[1];
+}
+//**********************************************************************************************************************************************************
 static void M24LC512_initWrite(void)
 {
   UCB0CTLW0 |= UCTR;                        // UCTR=1 => Transmit Mode (R/W bit = 0)
@@ -63,148 +258,610 @@ void M24LC512_byteWrite(const uint16_t Address, const uint8_t Data)
     adr_hi = Address >> 8;                    // calculate high byte
     adr_lo = Address & 0xFF;                  // and low byte of address
 
+    M24LC512_selectLowPowerMode(1);
     M24LC512_initWrite();
 
     UCB0CTLW0 |= UCTXSTT;                      // start condition generation
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0TXBUF = adr_hi;                        // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0TXBUF = adr_lo;                        // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0TXBUF = Data;                          // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0CTLW0 |= UCTXSTP;                      // I2C stop condition
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0IE &= ~(UCTXIE0 | UCSTPIE);    // disable Transmit ready interrupt
 }
 //**********************************************************************************************************************************************************
-void M24LC512_pageWrite(uint16_t* StartAddress, uint8_t *Data, const uint16_t Size)
+static void M24LC512_sendChunk(const uint16_t Address, const uint8_t *Prefix, const uint8_t PrefixSize,
+                               const uint8_t *Data, const uint16_t Size)
 {
-    volatile uint16_t i = 0;
-    volatile uint16_t index = 0;
-    volatile uint16_t counterI2cBuffer = 0;
-    uint8_t adr_hi;
-    uint8_t adr_lo;
-    uint16_t currentAddress = *StartAddress;
-    volatile uint16_t currentSize = Size;
-    volatile uint16_t status = 0;
-    uint8_t moreDataToRead = 1;
-    uint16_t auxSize;
-    uint32_t auxAddress = 128;
-    uint32_t tempAddress;
+    uint16_t i;
+
+    M24LC512_initWrite();
+
+    UCB0CTLW0 |= UCTXSTT;                                       // start condition generation => I2C communication is started
+    __bis_SR_register(lpmBits + GIE);                           // Enter LPM w/ interrupts
 
-    tempAddress = currentAddress;
-    while(tempAddress > 128)
+    UCB0TXBUF = Address >> 8;                                   // Load TX buffer - high byte of address
+    __bis_SR_register(lpmBits + GIE);
+
+    UCB0TXBUF = Address & 0x00FF;                               // Load TX buffer - low byte of address
+    __bis_SR_register(lpmBits + GIE);
+
+    for(i = 0 ; i < PrefixSize ; i++)
     {
-        tempAddress = tempAddress - 128;
-        auxAddress += 128;
+        UCB0TXBUF = Prefix[i];                                  // Sello de la pagina y/o encabezado del registro
+        __bis_SR_register(lpmBits + GIE);
     }
-    tempAddress = auxAddress;
 
-    // Execute until no more data in Data buffer
-    while(moreDataToRead)
+    for(i = 0 ; i < Size ; i++)
     {
-        adr_hi = currentAddress >> 8;                               // calculate high byte
-        adr_lo = currentAddress & 0x00FF;                           // and low byte of address
+        UCB0TXBUF = Data[i];                                    // Load TX buffer
+        __bis_SR_register(lpmBits + GIE);
+    }
+
+    UCB0CTLW0 |= UCTXSTP;                                       // I2C stop condition
+    __bis_SR_register(lpmBits + GIE);                           // Ensure stop condition got sent
+
+    M24LC512_ackPolling();                                      // Ensure data is written in EEPROM
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_translate(const uint16_t Address)
+{
+    uint16_t page = Address / M24LC512_MAXPAGEWRITE;
+    uint16_t i;
 
-        // Chop data down to 64-byte packets to be transmitted at a time
-        // Maintain pointer of current startaddress
-        if(currentSize > M24LC512_MAXPAGEWRITE)
+    // Se busca desde la ultima entrada: si una reserva fallo, la entrada mas nueva de la pagina es la vigente.
+    for(i = badPages.count ; i > 0 ; i--)
+    {
+        if(badPages.page[i - 1] == page)
         {
-            index = counterI2cBuffer;
-            auxAddress = currentAddress;
-            auxSize = currentSize;
-            counterI2cBuffer = counterI2cBuffer + M24LC512_MAXPAGEWRITE;
-            currentSize = currentSize - M24LC512_MAXPAGEWRITE;
-            currentAddress = currentAddress + M24LC512_MAXPAGEWRITE;
+            return ((M24LC512_SPARE_START + i - 1) * M24LC512_MAXPAGEWRITE) + (Address % M24LC512_MAXPAGEWRITE);
+        }
+    }
+
+    return Address;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_compare(uint16_t Address, const uint8_t *Data, uint16_t Size)
+{
+    uint16_t pieceSize;
+    uint16_t i;
+
+    while(Size > 0)
+    {
+        pieceSize = (Size > M24LC512_VERIFY_PIECE) ? M24LC512_VERIFY_PIECE : Size;
+
+        if(pieceSize == 1)
+        {
+            verifyBuffer[0] = M24LC512_readByte(Address);       // La lectura secuencial necesita al menos 2 bytes
         }
         else
         {
-            moreDataToRead = 0;
-            index = counterI2cBuffer;
-            auxAddress = currentAddress;
-            auxSize = currentSize;
-            counterI2cBuffer = counterI2cBuffer + currentSize;
-            currentAddress = currentAddress + currentSize;
+            M24LC512_readBlock(Address, verifyBuffer, pieceSize);
+        }
+
+        for(i = 0 ; i < pieceSize ; i++)
+        {
+            if(verifyBuffer[i] != Data[i])
+            {
+                return false;
+            }
         }
-        status = __get_SR_register();
-        if((status & C) || (status & (C | Z)))
+
+        Address += pieceSize;
+        Data += pieceSize;
+        Size -= pieceSize;
+    }
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_remapPage(const uint16_t Address, const uint8_t *Prefix, const uint8_t PrefixSize,
+                               const uint8_t *Data, const uint16_t Size)
+{
+    uint16_t page = Address / M24LC512_MAXPAGEWRITE;
+    uint16_t offset = Address % M24LC512_MAXPAGEWRITE;
+    uint16_t spare;
+    uint16_t i;
+    uint8_t state;
+    bool ok;
+
+    if(page >= M24LC512_SPARE_START)
+    {
+        return false;                                           // Las paginas de reserva no se reemplazan
+    }
+
+    // Se arma la pagina completa: lo que tenia hasta ahora con los datos nuevos encima.
+    M24LC512_readBlock(M24LC512_translate(Address - offset), pageBuffer, M24LC512_MAXPAGEWRITE);
+    memcpy(&pageBuffer[offset], Prefix, PrefixSize);
+    memcpy(&pageBuffer[offset + PrefixSize], Data, Size);
+
+    while(badPages.count < M24LC512_SPARE_PAGES)
+    {
+        spare = (M24LC512_SPARE_START + badPages.count) * M24LC512_MAXPAGEWRITE;
+
+        M24LC512_sendChunk(spare, 0, 0, pageBuffer, M24LC512_MAXPAGEWRITE);
+        ok = M24LC512_compare(spare, pageBuffer, M24LC512_MAXPAGEWRITE);
+
+        // Primero se agrega la entrada y despues se descartan las anteriores de la pagina, asi un reset en el medio
+        // deja la pagina apuntando a la reserva nueva o a la anterior, nunca a ninguna.
+        state = M24LC512_framUnlock();
+
+        badPages.page[badPages.count] = ok ? page : M24LC512_PAGE_RETIRED;
+        badPages.count++;
+
+        for(i = 0 ; ok && (i < (badPages.count - 1)) ; i++)
         {
-            countS++; // Contador de sobreescritura de la memoria.
-            counterI2cBuffer = index + (0xFFFF - auxAddress) + 1;
-            currentSize = auxAddress - (0xFFFF - auxSize) - 1;
-            currentAddress = 0x0000;
-            moreDataToRead = 1;
-            goto jump;
+            if(badPages.page[i] == page)
+            {
+                badPages.page[i] = M24LC512_PAGE_RETIRED;
+            }
         }
-        if(currentAddress > tempAddress)
+
+        M24LC512_framRestore(state);
+
+        if(ok)
         {
-            counterI2cBuffer = index + (tempAddress - auxAddress);
-            currentSize = auxAddress - (tempAddress - auxSize);
-            currentAddress = tempAddress;
-            moreDataToRead = 1;
+            return true;
         }
+    }
+
+    return false;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_crcCheck(const uint16_t Address, const uint8_t *Prefix, const uint8_t PrefixSize,
+                               const uint8_t *Data, const uint16_t Size)
+{
+    uint16_t expected;
+    uint16_t i;
 
-        jump:
-        if(tempAddress == 65536)
-            tempAddress = 0;
-        tempAddress += 128;
+    if((PrefixSize + Size) < 2)
+    {
+        return M24LC512_compare(Address, Prefix, PrefixSize) &&  // La lectura secuencial necesita al menos 2 bytes
+               M24LC512_compare(Address + PrefixSize, Data, Size);
+    }
+
+    CRC_setSeed(CRC_BASE, M24LC512_CRC_SEED);
+
+    for(i = 0 ; i < PrefixSize ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Prefix[i]);
+    }
 
-        M24LC512_initWrite();
+    for(i = 0 ; i < Size ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Data[i]);
+    }
 
-        UCB0CTLW0 |= UCTXSTT;                                       // start condition generation => I2C communication is started
-        __bis_SR_register(LPM3_bits + GIE);                         // Enter LPM0 w/ interrupts
+    expected = CRC_getResult(CRC_BASE);
+
+    // Una sola lectura de todo el bloque, que solo pasa por el modulo CRC: no necesita buffer.
+    CRC_setSeed(CRC_BASE, M24LC512_CRC_SEED);
+    crcStream = PrefixSize + Size;
+
+    M24LC512_readBlock(Address, NULL, PrefixSize + Size);
+
+    crcStream = 0;
+
+    return (CRC_getResult(CRC_BASE) == expected);
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_check(const uint16_t Address, const uint8_t *Prefix, const uint8_t PrefixSize,
+                           const uint8_t *Data, const uint16_t Size)
+{
+    if(verifyPolicy == M24LC512_VERIFY_CRC)
+    {
+        return M24LC512_crcCheck(Address, Prefix, PrefixSize, Data, Size);
+    }
+
+    return M24LC512_compare(Address, Prefix, PrefixSize) && M24LC512_compare(Address + PrefixSize, Data, Size);
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_setOutcome(const uint8_t Outcome)
+{
+    if(Outcome > writeOutcome)
+    {
+        writeOutcome = Outcome;
+    }
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_writeChunk(const uint16_t Address, const uint8_t *Prefix, const uint8_t PrefixSize,
+                                const uint8_t *Data, const uint16_t Size)
+{
+    uint16_t physical = M24LC512_translate(Address);
+    uint16_t transferBits;
+    uint8_t attempt;
+    bool ok;
+
+    M24LC512_sendChunk(physical, Prefix, PrefixSize, Data, Size);
+
+    if(verifyPolicy == M24LC512_VERIFY_NONE)
+    {
+        return true;
+    }
+
+    transferBits = lpmBits;                                     // Las relecturas eligen su propio modo de bajo consumo
+
+    // Un fallo aislado (ruido en el bus, caida de tension) se resuelve reescribiendo; solo si persiste se reubica.
+    ok = M24LC512_check(physical, Prefix, PrefixSize, Data, Size);
+    for(attempt = 0 ; !ok && (attempt < verifyRetries) ; attempt++)
+    {
+        M24LC512_sendChunk(physical, Prefix, PrefixSize, Data, Size);
+        ok = M24LC512_check(physical, Prefix, PrefixSize, Data, Size);
+    }
+
+    if(ok)
+    {
+        M24LC512_setOutcome((attempt == 0) ? M24LC512_WRITE_OK : M24LC512_WRITE_RETRIED);
+    }
+    else
+    {
+        ok = M24LC512_remapPage(Address, Prefix, PrefixSize, Data, Size);
+        M24LC512_setOutcome(ok ? M24LC512_WRITE_REMAPPED : M24LC512_WRITE_FAILED);
+    }
+
+    lpmBits = transferBits;
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_fillStamp(uint8_t *Stamp)
+{
+    // Al comenzar una pagina se antepone el sello con el numero de secuencia de la pagina y la epoca.
+    Stamp[0] = (uint8_t)(M24LC512_header.pageSequence >> 8);
+    Stamp[1] = (uint8_t)M24LC512_header.pageSequence;
+    Stamp[2] = (uint8_t)(M24LC512_header.epoch >> 8);
+    Stamp[3] = (uint8_t)M24LC512_header.epoch;
 
-        UCB0TXBUF = adr_hi;                                         // Load TX buffer
-        __bis_SR_register(LPM3_bits + GIE);
+    M24LC512_header.pageSequence = (M24LC512_header.pageSequence + 1) & M24LC512_STAMP_SEQUENCE_MASK;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_pageWrite(uint16_t* StartAddress, const uint8_t *Data, const uint16_t Size)
+{
+    bool ok = true;
+    uint16_t currentAddress = *StartAddress;
+    uint16_t currentSize = Size;
+    uint16_t pageRoom;
+    uint16_t chunkSize;
+    uint8_t stamp[M24LC512_STAMP_SIZE];
+    uint8_t stampSize;
+
+    writeOutcome = M24LC512_WRITE_OK;
+    M24LC512_selectLowPowerMode(Size);
+
+    // Se divide la escritura en partes que no crucen el limite de una pagina, sino el puntero interno
+    // de la memoria volveria al inicio de la pagina y se sobrescribirian los datos.
+    while(currentSize > 0)
+    {
+        if(writeAbort)
+        {
+            ok = false;                                             // La pagina anterior quedo completa, no se empieza otra
+            break;
+        }
 
-        UCB0TXBUF = adr_lo;                                         // Load TX buffer
-        __bis_SR_register(LPM3_bits + GIE);
+        // El registro circular vuelve al inicio antes de las paginas de reserva, que no son parte de el.
+        if(currentAddress >= M24LC512_SPARE_ADDRESS)
+        {
+            currentAddress = M24LC512_STARTADDRESS;
+            countS++;                                               // Contador de sobreescritura de la memoria.
+        }
 
-        for(i = counterI2cBuffer ; i > index ; i--)
+        stampSize = M24LC512_stampSize(currentAddress);
+        if(stampSize != 0)
         {
-            UCB0TXBUF = Data[(index + counterI2cBuffer) - i];       // Load TX buffer
-            __bis_SR_register(LPM3_bits + GIE);
+            M24LC512_fillStamp(stamp);
         }
 
-        UCB0CTLW0 |= UCTXSTP;                                       // I2C stop condition
-        __bis_SR_register(LPM3_bits + GIE);                         // Ensure stop condition got sent
+        pageRoom = M24LC512_MAXPAGEWRITE - (currentAddress % M24LC512_MAXPAGEWRITE) - stampSize;
+        chunkSize = (currentSize > pageRoom) ? pageRoom : currentSize;
 
-        M24LC512_ackPolling();                                      // Ensure data is written in EEPROM
+        if(!M24LC512_writeChunk(currentAddress, stamp, stampSize, Data, chunkSize))
+        {
+            ok = false;                                             // Se sigue escribiendo para no desfasar el puntero
+        }
+
+        Data += chunkSize;
+        currentSize -= chunkSize;
+        currentAddress += stampSize + chunkSize;
     }
 
     UCB0IE &= ~(UCTXIE0 | UCSTPIE);                                 // disable Transmit ready interrupt
     *StartAddress = currentAddress;
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_frameWrite(uint16_t *Address, const uint8_t *Frame, const uint8_t FrameSize,
+                         const uint8_t *Data, const uint16_t Size)
+{
+    uint8_t prefix[M24LC512_STAMP_SIZE + M24LC512_FRAME_MAX];
+    uint8_t prefixSize;
+    uint8_t i;
+    bool ok;
+
+    if(*Address >= M24LC512_SPARE_ADDRESS)
+    {
+        writeOutcome = M24LC512_WRITE_FAILED;                       // Las paginas de reserva solo se escriben al reubicar
+        return false;
+    }
+
+    writeOutcome = M24LC512_WRITE_OK;
+    M24LC512_selectLowPowerMode(FrameSize + Size);
+
+    prefixSize = M24LC512_stampSize(*Address);
+    if(prefixSize != 0)
+    {
+        M24LC512_fillStamp(prefix);
+    }
+
+    for(i = 0 ; i < FrameSize ; i++)
+    {
+        prefix[prefixSize++] = Frame[i];
+    }
+
+    // Sello, encabezado y datos van en una sola transaccion y un solo ciclo de escritura.
+    ok = M24LC512_writeChunk(*Address, prefix, prefixSize, Data, Size);
+
+    UCB0IE &= ~(UCTXIE0 | UCSTPIE);                                 // disable Transmit ready interrupt
+
+    *Address += prefixSize + Size;
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_pageProgram(const uint16_t Address, const uint8_t *Data, const uint16_t Size)
+{
+    bool ok;
+
+    writeOutcome = M24LC512_WRITE_OK;
+    M24LC512_selectLowPowerMode(Size);
+
+    ok = M24LC512_writeChunk(Address, 0, 0, Data, Size);
+
+    UCB0IE &= ~(UCTXIE0 | UCSTPIE);                                 // disable Transmit ready interrupt
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_rangeProgram(uint16_t Address, const uint8_t *Data, uint16_t Size)
+{
+    uint16_t chunkSize;
+    bool ok = true;
+
+    while(Size > 0)
+    {
+        chunkSize = M24LC512_MAXPAGEWRITE - (Address % M24LC512_MAXPAGEWRITE);
+        if(chunkSize > Size)
+        {
+            chunkSize = Size;
+        }
+
+        if(!M24LC512_pageProgram(Address, Data, chunkSize))
+        {
+            ok = false;
+        }
+
+        Address += chunkSize;
+        Data += chunkSize;
+        Size -= chunkSize;
+    }
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_setPageStamp(const bool Enable)
+{
+    pageStamp = Enable;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_setVerify(const bool Enable)
+{
+    verifyPolicy = Enable ? M24LC512_VERIFY_FULL : M24LC512_VERIFY_NONE;
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_setVerifyPolicy(const uint8_t Policy, const uint8_t Retries)
+{
+    uint8_t previous = verifyPolicy;
+
+    verifyPolicy = Policy;
+    verifyRetries = Retries;
+
+    return previous;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_pageProgramVerified(const uint16_t Address, const uint8_t *Data, const uint16_t Size, const uint8_t Policy)
+{
+    uint8_t previous = verifyPolicy;
+    bool ok;
+
+    verifyPolicy = Policy;
+    ok = M24LC512_pageProgram(Address, Data, Size);
+    verifyPolicy = previous;
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_abortWrites(const bool Abort)
+{
+    writeAbort = Abort;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_busBusy(void)
+{
+    // Toda espera en bajo consumo de la libreria tiene habilitada la interrupcion que la termina, y cada transferencia
+    // las deshabilita al terminar: no hace falta marcar cada espera y no se agregan ciclos por byte.
+    return ((UCB0IE & (UCTXIE0 | UCRXIE0 | UCSTPIE | UCSTTIE)) != 0) || ((TA1CCTL0 & CCIE) != 0);
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_writeResult(void)
+{
+    return writeOutcome;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_badPageCount(void)
+{
+    return badPages.count;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_rangesOverlap(const uint16_t StartA, const uint16_t CountA, const uint16_t StartB, const uint16_t CountB)
+{
+    return (CountA != 0) && (CountB != 0) && (StartA < (StartB + CountB)) && (StartB < (StartA + CountA));
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_pagesTaken(const uint8_t Partition, const uint8_t Zone, const uint16_t StartPage, const uint16_t PageCount)
+{
+    uint8_t i;
+
+    if(((uint32_t)StartPage + PageCount) > M24LC512_SPARE_START)
+    {
+        return true;
+    }
+
+    for(i = 0 ; i < M24LC512_PARTITIONS ; i++)
+    {
+        if((i != Partition) && M24LC512_rangesOverlap(StartPage, PageCount, M24LC512_header.partition[i].startPage,
+                                                      M24LC512_header.partition[i].pageCount))
+        {
+            return true;
+        }
+    }
+
+    for(i = 0 ; i < M24LC512_ZONES ; i++)
+    {
+        if((i != Zone) && M24LC512_rangesOverlap(StartPage, PageCount, zones[i].startPage, zones[i].pageCount))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_reserveZone(const uint8_t Zone, const uint16_t StartPage, const uint16_t PageCount)
+{
+    uint8_t state;
+
+    if((Zone >= M24LC512_ZONES) || M24LC512_pagesTaken(M24LC512_PARTITIONS, Zone, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    zones[Zone].startPage = StartPage;
+    zones[Zone].pageCount = PageCount;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_stampSize(const uint16_t Address)
+{
+    return (pageStamp && ((Address % M24LC512_MAXPAGEWRITE) == 0)) ? M24LC512_STAMP_SIZE : 0;
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_readStamp(const uint16_t Page, uint16_t *Epoch)
+{
+    uint8_t stamp[M24LC512_STAMP_SIZE];
+
+    M24LC512_sequentialRead(Page * M24LC512_MAXPAGEWRITE, stamp, M24LC512_STAMP_SIZE);
+
+    *Epoch = (((uint16_t)stamp[2]) << 8) | stamp[3];
+
+    return (((uint16_t)stamp[0]) << 8) | stamp[1];
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_pageIsCurrent(const uint16_t Page)
+{
+    uint16_t epoch;
+    uint16_t sequence = M24LC512_readStamp(Page, &epoch);
+
+    return !(sequence & M24LC512_STAMP_EMPTY) && (epoch == (uint16_t)M24LC512_header.epoch);
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_recoverHead(void)
+{
+    uint16_t first;
+    uint16_t firstEpoch;
+    uint16_t stamp;
+    uint16_t epoch;
+    uint16_t low = 0;
+    uint16_t high = M24LC512_SPARE_START;                           // Las paginas de repuesto no son parte del registro
+    uint16_t middle;
+
+    first = M24LC512_readStamp(0, &firstEpoch);
+
+    if(first & M24LC512_STAMP_EMPTY)
+    {
+        // La primera pagina nunca se escribio con sello: el registro esta vacio.
+        M24LC512_header.memPointer = M24LC512_STARTADDRESS;
+        M24LC512_header.pageSequence = 0;
+        M24LC512_commitHeader();
+        return M24LC512_header.memPointer;
+    }
+
+    // Las paginas de la vuelta actual cumplen sello == primero + pagina, las de la vuelta anterior,
+    // las de una epoca anterior o las que nunca se escribieron no. Se busca la ultima que lo cumple.
+    M24LC512_header.epoch = firstEpoch;
+
+    while((high - low) > 1)
+    {
+        middle = (low + high) / 2;
+        stamp = M24LC512_readStamp(middle, &epoch);
+
+        if(!(stamp & M24LC512_STAMP_EMPTY) && (epoch == firstEpoch) &&
+           (((stamp - first) & M24LC512_STAMP_SEQUENCE_MASK) == middle))
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    // Se continua en la pagina siguiente a la ultima escrita, o en la 0 si se llego a las paginas de repuesto.
+    M24LC512_header.memPointer = (uint16_t)(((low + 1) % M24LC512_SPARE_START) * M24LC512_MAXPAGEWRITE);
+    M24LC512_header.pageSequence = (first + low + 1) & M24LC512_STAMP_SEQUENCE_MASK;
+    M24LC512_commitHeader();
+
+    return M24LC512_header.memPointer;
 }
 //**********************************************************************************************************************************************************
 unsigned char M24LC512_currentRead(void)
 {
     volatile uint8_t aux, temp;
 
+    M24LC512_selectLowPowerMode(1);
+
     // Read Data byte
     M24LC512_initRead();
 
     UCB0CTLW0 |= UCTXSTP;
 
     UCB0CTLW0 |= UCTXSTT;                       // I2C start condition
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
     temp = UCB0RXBUF;
 
     UCB0IE |= UCSTPIE;
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
     UCB0IE &= ~(UCRXIE0 | UCSTPIE);
 
     return temp;
 }
 //**********************************************************************************************************************************************************
-uint8_t M24LC512_randomRead(const uint16_t Address)
+static uint8_t M24LC512_readByte(const uint16_t Address)
 {
     uint8_t adr_hi;
     uint8_t adr_lo;
@@ -213,20 +870,22 @@ uint8_t M24LC512_randomRead(const uint16_t Address)
     adr_hi = Address >> 8;                      // calculate high byte
     adr_lo = Address & 0x00FF;                  // and low byte of address
 
+    M24LC512_selectLowPowerMode(1);
+
     // Write Address first
     M24LC512_initWrite();
 
     UCB0CTLW0 |= UCTXSTT;                       // start condition generation
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0TXBUF = adr_hi;                         // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0TXBUF = adr_lo;    // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0CTLW0 |= UCTXSTP;                       // I2C stop condition
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
     // Read Data byte
     M24LC512_initRead();
@@ -234,19 +893,19 @@ uint8_t M24LC512_randomRead(const uint16_t Address)
     UCB0CTLW0 |= UCTXSTP;
 
     UCB0CTLW0 |= UCTXSTT;                       // I2C start condition
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
     temp = UCB0RXBUF;
 
     UCB0IE |= UCSTPIE;
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
     UCB0IE &= ~(UCRXIE0 | UCSTPIE);
 
     return temp;
 }
 //**********************************************************************************************************************************************************
-void M24LC512_sequentialRead(uint16_t Address , uint8_t *Data , uint16_t Size)
+static void M24LC512_readBlock(const uint16_t Address, uint8_t *Data, const uint16_t Size)
 {
     uint8_t adr_hi;
     uint8_t adr_lo;
@@ -255,48 +914,161 @@ void M24LC512_sequentialRead(uint16_t Address , uint8_t *Data , uint16_t Size)
     adr_hi = Address >> 8;                      // calculate high byte
     adr_lo = Address & 0x00FF;                  // and low byte of address
 
+    M24LC512_selectLowPowerMode(Size);
+
     // Write Address first
     M24LC512_initWrite();
 
     UCB0CTLW0 |= UCTXSTT;                       // start condition generation
-    __bis_SR_register(LPM3_bits + GIE);         // => I2C communication is started
+    __bis_SR_register(lpmBits + GIE);         // => I2C communication is started
                                                 // Enter LPM0 w/ interrupts
     UCB0TXBUF = adr_hi;                         // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
     UCB0TXBUF = adr_lo;                         // Load TX buffer
-    __bis_SR_register(LPM3_bits + GIE);
+    __bis_SR_register(lpmBits + GIE);
 
-    UCB0CTLW0 |= UCTXSTP;                       // I2C stop condition
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
-
-    // Read Data byte
+    // Read Data byte: start repetido sin stop, la direccion queda cargada y el bus no se libera entre medio.
     M24LC512_initRead();
 
-    UCB0CTLW0 |= UCTXSTT;                       // I2C start condition
+    UCB0CTLW0 |= UCTXSTT;                       // I2C repeated start condition
 
     for(counterSize = (Size-2) ; counterSize > 0  ; counterSize--)
     {
-        __bis_SR_register(LPM3_bits + GIE);     // Enter LPM0 w/ interrupts
-        Data[(Size-2) - counterSize] = UCB0RXBUF;
+        __bis_SR_register(lpmBits + GIE);     // Enter LPM0 w/ interrupts
+        M24LC512_storeByte(Data, (Size-2) - counterSize);
     }
 
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
     UCB0CTLW0 |= UCTXSTP;                       // I2C stop condition
 
-    Data[Size-2] = UCB0RXBUF;
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    M24LC512_storeByte(Data, Size-2);
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
-    Data[Size-1] = UCB0RXBUF;
+    M24LC512_storeByte(Data, Size-1);
 
     UCB0IE |= UCSTPIE;
-    __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+    __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
     UCB0IE &= ~(UCRXIE0 | UCSTPIE);
 }
 //**********************************************************************************************************************************************************
+uint8_t M24LC512_randomRead(const uint16_t Address)
+{
+    return M24LC512_readByte(M24LC512_translate(Address));
+}
+//**********************************************************************************************************************************************************
+void M24LC512_sequentialRead(uint16_t Address , uint8_t *Data , uint16_t Size)
+{
+    uint16_t chunkSize;
+
+    if(badPages.count == 0)
+    {
+        M24LC512_readBlock(Address, Data, Size);                // Sin paginas reemplazadas se lee de una sola vez
+        return;
+    }
+
+    // Cada pagina se lee de la posicion fisica que le indica la tabla.
+    while(Size > 0)
+    {
+        chunkSize = M24LC512_MAXPAGEWRITE - (Address % M24LC512_MAXPAGEWRITE);
+        if(chunkSize > Size)
+        {
+            chunkSize = Size;
+        }
+
+        if(chunkSize == 1)
+        {
+            Data[0] = M24LC512_readByte(M24LC512_translate(Address));
+        }
+        else
+        {
+            M24LC512_readBlock(M24LC512_translate(Address), Data, chunkSize);
+        }
+
+        Address += chunkSize;
+        Data += chunkSize;
+        Size -= chunkSize;
+    }
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_storeByte(uint8_t *Data, const uint16_t Index)
+{
+    uint8_t value = UCB0RXBUF;
+
+    if(Data != NULL)
+    {
+        Data[Index] = value;                                    // Sin buffer el byte solo pasa por el CRC
+    }
+
+    // Se calcula mientras llega el byte siguiente por el bus, sin otra pasada sobre los datos.
+    if(crcStream > 0)
+    {
+        CRC_set8BitData(CRC_BASE, value);
+        crcStream--;
+    }
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_crcPageWrite(const uint16_t Page, const uint8_t *Data)
+{
+    uint8_t crc[M24LC512_CRC_SIZE];
+    uint16_t result;
+    uint16_t i;
+    bool ok;
+
+    if(Page >= M24LC512_SPARE_START)
+    {
+        return false;
+    }
+
+    CRC_setSeed(CRC_BASE, M24LC512_CRC_SEED);
+
+    for(i = 0 ; i < M24LC512_CRC_DATA ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Data[i]);
+    }
+
+    result = CRC_getResult(CRC_BASE);
+    crc[0] = (uint8_t)(result >> 8);
+    crc[1] = (uint8_t)result;
+
+    writeOutcome = M24LC512_WRITE_OK;
+    M24LC512_selectLowPowerMode(M24LC512_MAXPAGEWRITE);
+
+    // Los datos van como prefijo y el CRC detras: la pagina completa se graba en un unico ciclo de escritura.
+    ok = M24LC512_writeChunk(Page * M24LC512_MAXPAGEWRITE, Data, M24LC512_CRC_DATA, crc, M24LC512_CRC_SIZE);
+
+    UCB0IE &= ~(UCTXIE0 | UCSTPIE);                                 // disable Transmit ready interrupt
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_crcPageRead(const uint16_t Page, uint8_t *Data)
+{
+    uint16_t result;
+
+    if(Page >= M24LC512_SPARE_START)
+    {
+        return false;
+    }
+
+    CRC_setSeed(CRC_BASE, M24LC512_CRC_SEED);
+    crcStream = M24LC512_CRC_DATA;
+
+    M24LC512_readBlock(M24LC512_translate(Page * M24LC512_MAXPAGEWRITE), Data, M24LC512_MAXPAGEWRITE);
+
+    crcStream = 0;
+    result = CRC_getResult(CRC_BASE);
+
+    return (Data[M24LC512_CRC_DATA] == (uint8_t)(result >> 8)) && (Data[M24LC512_CRC_DATA + 1] == (uint8_t)result);
+}
+//**********************************************************************************************************************************************************
 void M24LC512_ackPolling(void)
 {
+    uint16_t transferBits = lpmBits;                // Se conserva el modo de la transferencia en curso
+
+    M24LC512_selectLowPowerMode(0);
+
     do
     {
         UCB0IE |= UCTXIE0 | UCSTPIE;
@@ -312,7 +1084,7 @@ void M24LC512_ackPolling(void)
         }
 
         UCB0CTLW0 |= UCTXSTP;                   // stop condition is generated after. Wait till stop bit is reset
-        __bis_SR_register(LPM3_bits + GIE);     // Enter LPM0 w/ interrupts
+        __bis_SR_register(lpmBits + GIE);     // Enter LPM0 w/ interrupts
 
         UCB0IE &= ~(UCTXIE0 | UCSTPIE);
 
@@ -321,23 +1093,176 @@ void M24LC512_ackPolling(void)
     } while(UCNACKIFG & UCB0IFG);
 
     UCB0IFG &= ~(UCTXIFG0 | UCSTPIFG);
+
+    lpmBits = transferBits;
 }
 //**********************************************************************************************************************************************************//**********************************************************************************************************************************************************
+uint8_t M24LC512_framUnlock(void)
+{
+    uint8_t state = SYSCFG0 & (DFWP | PFWP);
+
+    SYSCFG0 &= ~(DFWP | PFWP);                  // Habilita las escrituras en la memoria FRAM.
+
+    return state;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_framRestore(const uint8_t State)
+{
+    SYSCFG0 = (SYSCFG0 & ~(DFWP | PFWP)) | State;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_crcContinue(const uint16_t Crc, const uint8_t *Data, const uint16_t Size)
+{
+    uint16_t i;
+
+    CRC_setSeed(CRC_BASE, Crc);
+
+    for(i = 0 ; i < Size ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Data[i]);
+    }
+
+    return CRC_getResult(CRC_BASE);
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_headerCrc(const M24LC512_Header *Header)
+{
+    const uint16_t *word = (const uint16_t *)Header;
+    uint16_t i;
+
+    CRC_setSeed(CRC_BASE, M24LC512_HEADER_CRC_SEED);
+
+    for(i = 0 ; i < (offsetof(M24LC512_Header, crc) / 2) ; i++)
+    {
+        CRC_set16BitData(CRC_BASE, word[i]);
+    }
+
+    return CRC_getResult(CRC_BASE);
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_headerIsValid(const M24LC512_Header *Header)
+{
+    return (Header->magic == M24LC512_HEADER_MAGIC) &&
+           (Header->version == M24LC512_HEADER_VERSION) &&
+           (Header->crc == M24LC512_headerCrc(Header));
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_loadHeader(void)
+{
+    const M24LC512_Header *slot = (const M24LC512_Header *)M24LC512_HEADER_ADDRESS;
+    bool valid0 = M24LC512_headerIsValid(&slot[0]);
+    bool valid1 = M24LC512_headerIsValid(&slot[1]);
+
+    if(!valid0 && !valid1)
+    {
+        M24LC512_header.sequence = 0;
+        activeSlot = 1;                                 // La primera escritura va a la copia 0
+        M24LC512_setinitValueHeader();
+        return false;
+    }
+
+    // Si las dos son validas gana la de mayor secuencia (comparacion con signo por si da la vuelta).
+    if(valid0 && (!valid1 || ((int32_t)(slot[0].sequence - slot[1].sequence) > 0)))
+    {
+        activeSlot = 0;
+    }
+    else
+    {
+        activeSlot = 1;
+    }
+
+    M24LC512_header = slot[activeSlot];
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_commitHeader(void)
+{
+    M24LC512_Header *slot = (M24LC512_Header *)M24LC512_HEADER_ADDRESS;
+    uint8_t state;
+
+    M24LC512_header.sequence++;
+    M24LC512_header.crc = M24LC512_headerCrc(&M24LC512_header);
+
+    state = M24LC512_framUnlock();
+    slot[activeSlot ^ 1] = M24LC512_header;             // Se escribe la copia inactiva
+    M24LC512_framRestore(state);
+
+    activeSlot ^= 1;                                    // y recien ahora pasa a ser la activa
+}
+//**********************************************************************************************************************************************************
 void M24LC512_setinitValueHeader(void)
 {
     uint16_t i = 0x0000;
+    uint8_t state;
+
+    M24LC512_header.magic = M24LC512_HEADER_MAGIC;
+    M24LC512_header.version = M24LC512_HEADER_VERSION;
+    M24LC512_header.flag = M24LC512_FLAG_NONE;
+    M24LC512_header.commPointer = M24LC512_STARTADDRESS;
+    M24LC512_header.memPointer = M24LC512_STARTADDRESS;
+    M24LC512_header.size = 0;
+    M24LC512_header.overwrites = 0;
+    M24LC512_header.pageSequence = 0;
+    M24LC512_header.epoch = 0;
+
+    // Por defecto la particion 0 ocupa la memoria hasta las paginas de reserva o la primera zona reservada, y el resto no se usa.
+    memset(M24LC512_header.partition, 0, sizeof(M24LC512_header.partition));
+    M24LC512_header.partition[0].pageCount = M24LC512_SPARE_START;
+    for(i = 0 ; i < M24LC512_ZONES ; i++)
+    {
+        if((zones[i].pageCount != 0) && (zones[i].startPage < M24LC512_header.partition[0].pageCount))
+        {
+            M24LC512_header.partition[0].pageCount = zones[i].startPage;
+        }
+    }
 
-    // Habilita las escrituras en la memoria FRAM.
-    SYSCFG0 &= ~DFWP;
+    state = M24LC512_framUnlock();
 
-    // Se coloca en cero el contador de sobreescritura, el flag de perdida de datos y la fecha y hora de la ultima medicion medicion.
-    for(i = 21 ; i > 7 ; i--)
+    // Se pone a cero la fecha y hora de la ultima medicion.
+    for(i = 21 ; i > 15 ; i--)
     {
         myArray[i] = 0x00;
     }
 
-    // Deshabilita las escrituras en la memoria FRAM.
-    SYSCFG0 |= DFWP;
+    M24LC512_framRestore(state);
+
+    // Se continua la secuencia para que la cabecera nueva sea la mas reciente.
+    M24LC512_commitHeader();
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_resetPointers(void)
+{
+    uint8_t i;
+    M24LC512_Partition *part;
+
+    // Al cambiar de epoca todas las paginas escritas hasta ahora pasan a considerarse vacias.
+    M24LC512_header.epoch++;
+
+    M24LC512_header.commPointer = M24LC512_STARTADDRESS;
+    M24LC512_header.memPointer = M24LC512_STARTADDRESS;
+    M24LC512_header.overwrites = 0;
+    M24LC512_header.flag = M24LC512_FLAG_NONE;
+    countS = 0;
+
+    for(i = 0 ; i < M24LC512_PARTITIONS ; i++)
+    {
+        part = &M24LC512_header.partition[i];
+        part->head = part->startPage * M24LC512_MAXPAGEWRITE;
+        part->commPointer = part->head;
+        part->pending = 0;
+        part->wraps = 0;
+        part->flag = M24LC512_FLAG_NONE;
+        // La secuencia de los registros continua para no confundirlos con los de la epoca anterior.
+        part->oldest = part->head;
+        part->oldestSequence = part->nextSequence;
+    }
+}
+//**********************************************************************************************************************************************************
+void M24LC512_clearLog(void)
+{
+    M24LC512_resetPointers();
+    M24LC512_commitHeader();
 }
 //**********************************************************************************************************************************************************
 void M24LC512_updateHeader(const uint16_t currentAddress, const uint16_t size)
@@ -345,77 +1270,55 @@ void M24LC512_updateHeader(const uint16_t currentAddress, const uint16_t size)
     uint16_t address;
     uint16_t count;
 
-    // Habilita las escrituras en la memoria FRAM.
-    SYSCFG0 &= ~DFWP;
-
-    if((myArray[15] != 2) && (myArray[15] != 3))
+    if((M24LC512_header.flag != M24LC512_FLAG_SENT) && (M24LC512_header.flag != M24LC512_FLAG_RESET))
     {
-        // Obtengo el puntero que tiene la direccion a partir de la cual se debe enviar los datos cuando se soliciten por comando - Ptro de la comunicacin.
-        address = ((((uint16_t)(myArray[7])) << 8) | myArray[8]);
+        // Puntero a partir del cual se deben enviar los datos cuando se soliciten por comando - Ptro de la comunicacin.
+        address = M24LC512_header.commPointer;
 
-        // Obtengo el contador de sobreescrituras.
-        count = ((((uint16_t)(myArray[13])) << 8) | myArray[14]);
+        // Contador de sobreescrituras.
+        count = M24LC512_header.overwrites;
 
         // Actualizo la direccin de bytes escritos en memoria - currentAddress - Puntero de la memoria
-        myArray[9] = ((uint8_t)(currentAddress >> 8));  // Parte alta
-        myArray[10] = (uint8_t)currentAddress;          // Parte baja
+        M24LC512_header.memPointer = currentAddress;
 
-        // Actualizo el contador de sobreescrituras cuando ocurra una sobreescritura en la memoria.
+        // Actualizo el contador de sobreescrituras cuando ocurra una sobreescritura en la memoria (aprox. cada 7 dias).
         if(countS > count)
         {
-            // Actualizo la cantidad de sobreescrituras (aprox. cada 7 dias) - count
-            myArray[13] = ((uint8_t)(countS >> 8));     // Parte alta
-            myArray[14] = (uint8_t)countS;              // Parte baja
+            M24LC512_header.overwrites = countS;
         }
 
         // Verifica que si se han perdido datos.
         if((address <= currentAddress) && (countS > count))
         {
-            myArray[15] = 1;
+            M24LC512_header.flag = M24LC512_FLAG_DATA_LOST;
         }
     }
 
-    switch(myArray[15])
+    switch(M24LC512_header.flag)
     {
-        case 1:
+        case M24LC512_FLAG_DATA_LOST:
             // En caso de que se pierdan datos se va actualizando la direccin desde donde se debe enviar lo datos por RF.
-            myArray[7] = ((uint8_t)(currentAddress >> 8)); // Parte alta.
-            myArray[8] = ((uint8_t)currentAddress);        // Parte baja.
+            M24LC512_header.commPointer = currentAddress;
             break;
 
-        case 2:
+        case M24LC512_FLAG_SENT:
             // Cuando hubo una transmision exitosa el puntero de la comunicacion se actualiza al puntero de la memoria para enviar nuevos datos.
-            myArray[7] = myArray[9];
-            myArray[8] = myArray[10];
+            M24LC512_header.commPointer = M24LC512_header.memPointer;
 
-            // Actualizo a cero el flag.
-            myArray[15] = 0;           // Como ya se indico que los si los datos se perdieron o no se pone a cero para poder indicar nuevamente cuando ocurra una nueva perdidad de datos.
+            // Como ya se indico si los datos se perdieron o no se pone a cero para poder indicar nuevamente cuando ocurra una nueva perdidad de datos.
+            M24LC512_header.flag = M24LC512_FLAG_NONE;
             break;
 
-        case 3:
-            // Actualizo la direccion de inicio donde se guardan los datos en la memoria - startAddress - Puntero de la comunicacion
-            myArray[7] = 0x00;  // Parte alta
-            myArray[8] = 0x00;  // Parte baja
-
-            // Actualizo la direccin de bytes escritos en memoria al inicio - currentAddress - Puntero de la memoria
-            myArray[9] = 0x00;  // Parte alta
-            myArray[10] = 0x00; // Parte baja
-
-            // Se pone a cero el contador de sobreescrituras - count
-            myArray[13] = 0x00;  // Parte alta
-            myArray[14] = 0x00;  // Parte baja
-
-            // Se pone a cero el flag de perdidas de datos.
-            myArray[15] = 0;
+        case M24LC512_FLAG_RESET:
+            // Se vuelven al inicio los punteros, se pone a cero el contador de sobreescrituras y se pasa a una nueva epoca.
+            M24LC512_resetPointers();
             break;
     }
 
     // Actualizo la cantidad de bytes escritos en memoria - size
-    myArray[11] = ((uint8_t)(size >> 8));  // Parte alta
-    myArray[12] = ((uint8_t)size);         // Parte baja
+    M24LC512_header.size = size;
 
-    // Deshabilita las escrituras en la memoria FRAM.
-    SYSCFG0 |= DFWP;
+    M24LC512_commitHeader();
 }
 //**********************************************************************************************************************************************************
 bool M24LC512_memoryCheck(void)
@@ -424,6 +1327,8 @@ bool M24LC512_memoryCheck(void)
     static uint8_t temp = 0;
     uint8_t contWhile = 3;
 
+    M24LC512_selectLowPowerMode(0);
+
     do
     {
         UCB0IE |= UCTXIE0 | UCSTPIE;
@@ -451,28 +1356,27 @@ bool M24LC512_memoryCheck(void)
     if(contDo != 0 && !(UCNACKIFG & UCB0IFG) && !(UCTXSTT & UCB0CTLW0) && (UCTXIFG0 & UCB0IFG))
     {
         // Es necesario hacer una transmision completa para verificar la conexion si no no envia el stop lo que ocasiona problemas en posteriores accesos de memoria.
-        __bis_SR_register(LPM3_bits + GIE);         // for start
+        __bis_SR_register(lpmBits + GIE);         // for start
 
         UCB0TXBUF = 0x00;                           // Load TX buffer
-        __bis_SR_register(LPM3_bits + GIE);
+        __bis_SR_register(lpmBits + GIE);
 
         UCB0TXBUF = 0x00;                           // Load TX buffer
-        __bis_SR_register(LPM3_bits + GIE);
+        __bis_SR_register(lpmBits + GIE);
 
         UCB0CTLW0 |= UCTXSTP;                       // I2C stop condition
-        __bis_SR_register(LPM3_bits + GIE);         // Enter LPM0 w/ interrupts
+        __bis_SR_register(lpmBits + GIE);         // Enter LPM0 w/ interrupts
 
         UCB0IE &= ~(UCTXIE0 | UCSTPIE | UCSTTIE);
         UCB0IFG &= ~(UCTXIFG0 | UCSTTIFG | UCSTPIFG);
 
-        if(myArray[15] == 4)    // Verifica si anteriormente no habia estado repondiendo.
+        if(M24LC512_header.flag == M24LC512_FLAG_NOT_RESPONDING)    // Verifica si anteriormente no habia estado repondiendo.
         {
-            SYSCFG0 &= ~DFWP;   // Habilita las escrituras en la memoria FRAM.
-            myArray[15] = temp; // En caso de que, anteriormente, no hubiese respondido y luego al intentarlo de nuevo (o reiniciarlo) vuelve a responder y retome el valor que tenia.
-            SYSCFG0 |= DFWP;    // Deshabilita las escrituras en la memoria FRAM.
+            M24LC512_header.flag = temp;    // En caso de que, anteriormente, no hubiese respondido y luego al intentarlo de nuevo (o reiniciarlo) vuelve a responder y retome el valor que tenia.
+            M24LC512_commitHeader();
         }else
         {
-            temp = myArray[15]; // Se va almacenando el ultimo valor para luego si deja de responder y vuelve a responder retoma el valor de antes.
+            temp = M24LC512_header.flag;    // Se va almacenando el ultimo valor para luego si deja de responder y vuelve a responder retoma el valor de antes.
         }
 
         return true;
@@ -484,9 +1388,8 @@ bool M24LC512_memoryCheck(void)
         UCB0IFG &= ~(UCTXIFG0 | UCSTPIFG);
         UCB0CTLW0 &= ~UCTXSTT;
 
-        SYSCFG0 &= ~DFWP;
-        myArray[15] = 4;
-        SYSCFG0 |= DFWP;
+        M24LC512_header.flag = M24LC512_FLAG_NOT_RESPONDING;
+        M24LC512_commitHeader();
 
         return false;
     }
@@ -532,3 +1435,17 @@ void __attribute__ ((interrupt(USCI_B0_VECTOR))) USCIB0_ISR (void)
     default: break;
   }
 }
+//********************************************************************************************************************************************************************
+// Timer1_A0 interrupt service routine - medicion del costo de salida de bajo consumo
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER1_A0_VECTOR
+__interrupt void TIMER1_A0_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER1_A0_VECTOR))) TIMER1_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    TA1CCTL0 &= ~CCIE;
+    __bic_SR_register_on_exit(LPM3_bits + GIE);
+}
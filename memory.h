@@ -43,6 +43,110 @@ extern uint8_t *myArray;
 //*****************************************************************************
 extern uint16_t countS;
 
+//*****************************************************************************
+//! \details Desplazamiento, respecto de \b FRAM_START, de la cabecera de la
+//!          memoria. Los primeros 32 bytes quedan para la configuracin de
+//!          los sensores y la fecha y hora de la ltima medicin.
+//*****************************************************************************
+#define M24LC512_HEADER_OFFSET  0x0020
+
+//*****************************************************************************
+//! \details Direccin de la FRAM donde se guarda la cabecera de la memoria.
+//*****************************************************************************
+#define M24LC512_HEADER_ADDRESS (FRAM_START + M24LC512_HEADER_OFFSET)
+
+//*****************************************************************************
+//! \details Nmero mgico que identifica una cabecera inicializada.
+//*****************************************************************************
+#define M24LC512_HEADER_MAGIC   0x4C32
+
+//*****************************************************************************
+//! \details Versin del formato de la cabecera. Se debe incrementar cada vez
+//!          que se modifique \b M24LC512_Header.
+//*****************************************************************************
+#define M24LC512_HEADER_VERSION 7
+
+//*****************************************************************************
+//! \details Cantidad de copias de la cabecera en la FRAM. Se escribe siempre
+//!          la copia inactiva, de modo que un corte de alimentacin durante
+//!          la escritura deja intacta la copia anterior.
+//*****************************************************************************
+#define M24LC512_HEADER_SLOTS   2
+
+//*****************************************************************************
+//! \details Valor inicial del CRC16 de la cabecera.
+//*****************************************************************************
+#define M24LC512_HEADER_CRC_SEED 0xFFFF
+
+//*****************************************************************************
+//! \details Valores del flag de prdida de datos de la cabecera.
+//*****************************************************************************
+#define M24LC512_FLAG_NONE          0   //!< Sin prdida de datos.
+#define M24LC512_FLAG_DATA_LOST     1   //!< Se sobrescribieron datos no enviados.
+#define M24LC512_FLAG_SENT          2   //!< Comando: los datos se enviaron correctamente.
+#define M24LC512_FLAG_RESET         3   //!< Comando: se vuelven a cero los punteros.
+#define M24LC512_FLAG_NOT_RESPONDING 4  //!< La memoria dej de responder.
+
+//*****************************************************************************
+//! \details Cantidad de particiones del registro que guarda la cabecera.
+//*****************************************************************************
+#define M24LC512_PARTITIONS     4
+
+//*****************************************************************************
+//! \details Particin del registro: un rango de pginas de la memoria con su
+//!          propio puntero de escritura, puntero de la comunicacin y
+//!          contador de vueltas.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t startPage;     //!< Primera pgina de la particin.
+    uint16_t pageCount;     //!< Cantidad de pginas, 0 si no se usa.
+    uint16_t head;          //!< Prxima direccin a escribir.
+    uint16_t commPointer;   //!< Prxima direccin a enviar.
+    uint32_t pending;       //!< Bytes escritos que todava no se enviaron.
+    uint16_t wraps;         //!< Cantidad de vueltas del puntero de escritura.
+    uint16_t flag;          //!< M24LC512_FLAG_DATA_LOST si se perdieron datos.
+    uint16_t oldest;        //!< Direccin del registro ms viejo (record.c).
+    uint16_t oldestSequence;//!< Nmero de secuencia del registro ms viejo.
+    uint16_t nextSequence;  //!< Nmero de secuencia del prximo registro.
+    uint16_t reserved;      //!< Mantiene la entrada alineada a 4 bytes.
+} M24LC512_Partition;
+
+_Static_assert(sizeof(M24LC512_Partition) == 24, "M24LC512_Partition con relleno");
+
+//*****************************************************************************
+//! \details Cabecera de la memoria guardada en la FRAM. Los campos estn
+//!          ordenados de forma que ninguno quede desalineado y la estructura
+//!          no tenga bytes de relleno, lo que se verifica en tiempo de
+//!          compilacin. El CRC debe ser siempre el ltimo campo, ya que se
+//!          calcula sobre todos los anteriores.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t magic;         //!< \b M24LC512_HEADER_MAGIC.
+    uint8_t  version;       //!< \b M24LC512_HEADER_VERSION.
+    uint8_t  flag;          //!< Flag de prdida de datos (M24LC512_FLAG_xxx).
+    uint16_t commPointer;   //!< Puntero de la comunicacin.
+    uint16_t memPointer;    //!< Puntero de la memoria.
+    uint16_t size;          //!< Cantidad de datos escritos.
+    uint16_t overwrites;    //!< Cantidad de sobreescrituras.
+    M24LC512_Partition partition[M24LC512_PARTITIONS]; //!< Tabla de particiones.
+    uint32_t sequence;      //!< Nmero de secuencia, la copia ms nueva es la mayor.
+    uint32_t epoch;         //!< poca del registro, se incrementa al borrarlo.
+    uint16_t pageSequence;  //!< Nmero de secuencia del prximo sello de pgina.
+    uint16_t crc;           //!< CRC16 de los campos anteriores.
+} M24LC512_Header;
+
+_Static_assert(sizeof(M24LC512_Header) == (24 + (M24LC512_PARTITIONS * sizeof(M24LC512_Partition))), "M24LC512_Header con relleno");
+_Static_assert((M24LC512_HEADER_OFFSET + M24LC512_HEADER_SLOTS * sizeof(M24LC512_Header)) <= 0x0200,
+               "M24LC512_Header no entra en INFOA");
+
+//*****************************************************************************
+//! \details Copia de trabajo de la cabecera en RAM. Se modifica libremente y
+//!          se guarda en la FRAM con \a M24LC512_commitHeader().
+//*****************************************************************************
+extern M24LC512_Header M24LC512_header;
+
 //*****************************************************************************
 //! @}
 //*****************************************************************************
@@ -68,6 +172,115 @@ extern uint16_t countS;
 //*****************************************************************************
 #define M24LC512_STARTADDRESS   0x0000
 
+//*****************************************************************************
+//! \details Cantidad de pginas de la memoria.
+//*****************************************************************************
+#define M24LC512_PAGES          512
+
+//*****************************************************************************
+//! \details Pginas de reserva al final de la memoria. Reemplazan a las
+//!          pginas que fallan la verificacin de la escritura y no se usan
+//!          en el registro ni en las particiones.
+//*****************************************************************************
+#define M24LC512_SPARE_PAGES    8
+
+//*****************************************************************************
+//! \details Primera pgina de reserva. El registro y las particiones usan
+//!          las pginas anteriores.
+//*****************************************************************************
+#define M24LC512_SPARE_START    (M24LC512_PAGES - M24LC512_SPARE_PAGES)
+
+//*****************************************************************************
+//! \details Primera direccin de las pginas de reserva. El registro de
+//!          \b memPointer vuelve a la direccin 0 al llegar a ella.
+//*****************************************************************************
+#define M24LC512_SPARE_ADDRESS  ((uint16_t)(M24LC512_SPARE_START * M24LC512_MAXPAGEWRITE))
+
+//*****************************************************************************
+//! \details Pgina de reserva descartada por fallar ella misma.
+//*****************************************************************************
+#define M24LC512_PAGE_RETIRED   0xFFFF
+
+//*****************************************************************************
+//! \details Zonas de pginas que reservan los mdulos que no escriben en una
+//!          particin. Una zona no se puede superponer con otra zona ni con
+//!          una particin.
+//*****************************************************************************
+//! @name Zonas reservadas
+//! @{
+#define M24LC512_ZONE_WEAR      0   //!< \a M24LC512_wearInit().
+#define M24LC512_ZONE_BLOB      1   //!< \a M24LC512_blobInit().
+#define M24LC512_ZONE_FILE      2   //!< \a M24LC512_fileFormat().
+#define M24LC512_ZONE_ECC       3   //!< \a M24LC512_eccInit(), una por rango.
+#define M24LC512_ZONES          7   //!< Cantidad de zonas.
+//! @}
+
+//*****************************************************************************
+//! \details Bytes que se releen por transaccin al verificar una escritura.
+//*****************************************************************************
+#define M24LC512_VERIFY_PIECE   16
+
+//*****************************************************************************
+//! \details Relectura de las escrituras (ver \a M24LC512_setVerifyPolicy()).
+//*****************************************************************************
+//! @name Polticas de verificacin
+//! @{
+#define M24LC512_VERIFY_NONE    0   //!< Sin relectura.
+#define M24LC512_VERIFY_CRC     1   //!< Se compara el CRC16 de lo reledo.
+#define M24LC512_VERIFY_FULL    2   //!< Se compara byte a byte.
+//! @}
+
+//*****************************************************************************
+//! \details Reintentos de escritura por defecto antes de reubicar una pgina.
+//*****************************************************************************
+#define M24LC512_VERIFY_RETRIES 2
+
+//*****************************************************************************
+//! \details Resultado de la ltima escritura, de menor a mayor gravedad (ver
+//!          \a M24LC512_writeResult()).
+//*****************************************************************************
+//! @name Resultados de escritura
+//! @{
+#define M24LC512_WRITE_OK       0   //!< Verificada (o sin verificar) al primer intento.
+#define M24LC512_WRITE_RETRIED  1   //!< Verificada despus de reescribir.
+#define M24LC512_WRITE_REMAPPED 2   //!< Se reubic la pgina en una reserva.
+#define M24LC512_WRITE_FAILED   3   //!< No se pudo escribir correctamente.
+//! @}
+
+//*****************************************************************************
+//! \details CRC16 de las pginas protegidas, en sus ltimos 2 bytes.
+//*****************************************************************************
+//! @name Pginas con CRC
+//! @{
+#define M24LC512_CRC_SIZE       2
+#define M24LC512_CRC_DATA       (M24LC512_MAXPAGEWRITE - M24LC512_CRC_SIZE)
+#define M24LC512_CRC_SEED       0xFFFF
+//! @}
+
+//*****************************************************************************
+//! \details Tamao del sello que se antepone a cada pgina cuando est
+//!          habilitado con \a M24LC512_setPageStamp(): nmero de secuencia
+//!          (2 bytes) y los 16 bits menos significativos de la poca (2 bytes).
+//*****************************************************************************
+#define M24LC512_STAMP_SIZE     4
+
+//*****************************************************************************
+//! \details El bit ms significativo del sello est en cero en una pgina
+//!          sellada. Una pgina borrada (0xFF) lo tiene en uno.
+//*****************************************************************************
+#define M24LC512_STAMP_EMPTY    0x8000
+
+//*****************************************************************************
+//! \details Mscara del nmero de secuencia del sello.
+//*****************************************************************************
+#define M24LC512_STAMP_SEQUENCE_MASK 0x7FFF
+
+//*****************************************************************************
+//! \details Tamao mximo del encabezado que se puede anteponer a los datos
+//!          con \a M24LC512_frameWrite().
+//*****************************************************************************
+#define M24LC512_FRAME_MAX      8
+
 //*****************************************************************************
 //! @}
 //*****************************************************************************
@@ -126,6 +339,134 @@ extern uint16_t countS;
 //! @}
 //*****************************************************************************
 
+//*****************************************************************************
+//                              Perfiles de reloj
+//*****************************************************************************
+//*****************************************************************************
+//! @name Perfiles de reloj:
+//! \brief Perfiles de reloj del sistema que puede seleccionar el driver.
+//! @{
+//*****************************************************************************
+//*****************************************************************************
+//! \details Perfil por defecto: MCLK = SMCLK = DCOCLKDIV de ~1 MHz, sin
+//!          estados de espera en la FRAM y divisor I2C
+//!          \b M24LC512_PIN_SCL_CLOCK_DIV.
+//*****************************************************************************
+#define M24LC512_CLOCK_DEFAULT              0x00
+
+//*****************************************************************************
+//! \details Perfil de alto rendimiento: MCLK = SMCLK = 16 MHz generados por el
+//!          FLL a partir del REFO, con un estado de espera en la FRAM.
+//*****************************************************************************
+#define M24LC512_CLOCK_PERFORMANCE          0x01
+
+//*****************************************************************************
+//! \details Frecuencia de referencia del FLL (REFO) en Hz.
+//*****************************************************************************
+#define M24LC512_FLLREF_HZ                  32768UL
+
+//*****************************************************************************
+//! \details Frecuencia de SMCLK, en KHz, de cada perfil.
+//*****************************************************************************
+#define M24LC512_DEFAULT_SMCLK_KHZ          1048
+#define M24LC512_PERFORMANCE_SMCLK_KHZ      16000
+
+//*****************************************************************************
+//! \details Frecuencia mxima de MCLK, en KHz, a la que la FRAM del
+//!          MSP430FR4133 puede trabajar sin estados de espera.
+//*****************************************************************************
+#define M24LC512_FRAM_NOWAIT_MAX_KHZ        8000
+
+//*****************************************************************************
+//! \details Frecuencia de SCL, en KHz, que se configura al pasar al perfil de
+//!          alto rendimiento.
+//*****************************************************************************
+#define M24LC512_PERFORMANCE_SCL_KHZ        400
+
+//*****************************************************************************
+//! \details Frecuencia mxima de SCL, en KHz, que admite la memoria. El
+//!          24LC512 est especificado hasta 400 KHz; solo el 24FC512 llega a
+//!          1 MHz, y con esa memoria se puede subir a 1000.
+//*****************************************************************************
+#define M24LC512_MAX_SCL_KHZ                400
+
+//*****************************************************************************
+//! \details Divisor mnimo de SMCLK que se carga en \b UCB0BRW. Por debajo de
+//!          4 el eUSCI_B no genera correctamente SCL en modo maestro.
+//*****************************************************************************
+#define M24LC512_MIN_SCL_DIVIDER            4
+
+//*****************************************************************************
+//! @}
+//*****************************************************************************
+
+//*****************************************************************************
+//                              Poltica de bajo consumo
+//*****************************************************************************
+//*****************************************************************************
+//! @name Poltica de bajo consumo:
+//! \brief Modo de bajo consumo en el que se espera cada byte de una
+//!        transferencia.
+//! @{
+//*****************************************************************************
+//*****************************************************************************
+//! \details El driver elige LPM0 o LPM3 en cada transferencia segn su tamao,
+//!          la velocidad del bus y el costo de salida medido.
+//*****************************************************************************
+#define M24LC512_LPM_AUTO                   0x00
+
+//*****************************************************************************
+//! \details Se espera siempre en LPM0 (CPU apagada, relojes encendidos).
+//*****************************************************************************
+#define M24LC512_LPM_0                      0x01
+
+//*****************************************************************************
+//! \details Se espera siempre en LPM3, el comportamiento original del driver.
+//*****************************************************************************
+#define M24LC512_LPM_3                      0x02
+
+//*****************************************************************************
+//! \details Transferencias de hasta esta cantidad de bytes se esperan en LPM0,
+//!          ya que la latencia de salida de LPM3 domina sobre el ahorro.
+//*****************************************************************************
+#define M24LC512_LPM_SHORT_TRANSFER         4
+
+//*****************************************************************************
+//! \details Si el costo extra de salir de LPM3 multiplicado por este factor
+//!          supera la duracin de un byte en el bus se usa LPM0.
+//*****************************************************************************
+#define M24LC512_LPM_WAKEUP_RATIO           4
+
+//*****************************************************************************
+//! \details Ciclos de SMCLK que se programan en el Timer_A1 para medir el
+//!          costo de salida de cada modo de bajo consumo.
+//*****************************************************************************
+#define M24LC512_WAKEUP_PROBE_CYCLES        200
+
+//*****************************************************************************
+//! @}
+//*****************************************************************************
+
+//*****************************************************************************
+//! \details Tabla de pginas defectuosas, guardada en la FRAM. La entrada
+//!          \b i indica qu pgina reemplaza la pgina de reserva
+//!          \b M24LC512_SPARE_START + \b i.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t count;                         //!< Pginas de reserva usadas.
+    uint16_t page[M24LC512_SPARE_PAGES];    //!< Pgina reemplazada o \b M24LC512_PAGE_RETIRED.
+} M24LC512_BadPages;
+
+//*****************************************************************************
+//! \details Pginas reservadas por un mdulo, guardadas en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t startPage;                     //!< Primera pgina de la zona.
+    uint16_t pageCount;                     //!< Cantidad de pginas, 0 si est libre.
+} M24LC512_Reservation;
+
 //*****************************************************************************
 //                              Funciones prototipos
 //*****************************************************************************
@@ -153,15 +494,113 @@ extern uint16_t countS;
 //!          asigna la direccin del esclavo con el que se quiere comunicar.
 //!          Mediante un \c if() se verifica si el bus est ocupado, si resulta
 //!          verdadero desactiva la seal de reloj y la genera manualmente.
+//!          Por ltimo se habilita el pedido de reloj de SMCLK para que el
+//!          eUSCI_B lo mantenga activo mientras se espera en LPM3.
 //!
 //! \return \c void.
 //!
 //! \attention Modifica los bits de los registros \b P5SEL, \b UCB0CTLW0,
-//!            \b UCB0BRW, \b UCB0I2CSA, \b P5DIR, \b P5OUT, \b UCB0IE y
-//!            \b UCB0IFG.
+//!            \b UCB0BRW, \b UCB0I2CSA, \b P5DIR, \b P5OUT, \b UCB0IE,
+//!            \b UCB0IFG y \b CSCTL8.
 //*****************************************************************************
 void M24LC512_initPort(void);
 
+//*****************************************************************************
+//! \brief Configura el sistema de reloj segn el perfil indicado.
+//!
+//! \details \b Descripcin \n
+//!          Con el perfil \b M24LC512_CLOCK_PERFORMANCE primero se configura
+//!          un estado de espera en la FRAM, ya que por encima de 8 MHz la
+//!          FRAM no puede responder en un solo ciclo, luego se selecciona el
+//!          REFO como referencia del FLL y se lleva MCLK y SMCLK a 16 MHz
+//!          mediante \a CS_initFLLSettle(). Con el perfil
+//!          \b M24LC512_CLOCK_DEFAULT se vuelve a ~1 MHz y recin despus se
+//!          quitan los estados de espera. En ambos casos se recalcula el
+//!          divisor del eUSCI_B para que la frecuencia de SCL sea coherente
+//!          con la nueva frecuencia de SMCLK.
+//!
+//! \param Profile Perfil de reloj, \b M24LC512_CLOCK_DEFAULT o
+//!        \b M24LC512_CLOCK_PERFORMANCE.
+//!
+//! \return \c true si el FLL se configur correctamente.
+//!
+//! \attention Modifica los bits de los registros \b FRCTL0, \b CSCTL0,
+//!            \b CSCTL1, \b CSCTL2, \b CSCTL3, \b CSCTL4, \b CSCTL5 y
+//!            \b UCB0BRW.
+//*****************************************************************************
+bool M24LC512_initClock(const uint8_t Profile);
+
+//*****************************************************************************
+//! \brief Configura la frecuencia de SCL de la comunicacin I2C.
+//!
+//! \details \b Descripcin \n
+//!          Calcula el divisor del eUSCI_B a partir de la frecuencia de
+//!          SMCLK del perfil de reloj actual, redondeando hacia arriba para
+//!          no superar nunca la frecuencia pedida. El divisor nunca baja de
+//!          \b M24LC512_MIN_SCL_DIVIDER, as que con SMCLK lento SCL puede
+//!          quedar por debajo de lo pedido. Si el mdulo ya est
+//!          configurado en modo I2C el divisor se carga con \b UCSWRST en
+//!          alto, si no se guarda para la prxima llamada a
+//!          \a M24LC512_initPort().
+//!
+//! \param SclKHz Frecuencia de SCL deseada en KHz, de 1 a
+//!               \b M24LC512_MAX_SCL_KHZ (400 para el 24LC512; 1000 solo
+//!               con un 24FC512).
+//!
+//! \return \c true si se configur, \c false si \a SclKHz es 0 o supera
+//!         \b M24LC512_MAX_SCL_KHZ; en ese caso el divisor no cambia.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0 y \b UCB0BRW.
+//*****************************************************************************
+bool M24LC512_setBusSpeed(const uint16_t SclKHz);
+
+//*****************************************************************************
+//! \brief Selecciona la poltica de bajo consumo de las transferencias.
+//!
+//! \details \b Descripcin \n
+//!          Con \b M24LC512_LPM_AUTO cada transferencia elige LPM0 si es
+//!          corta (\b M24LC512_LPM_SHORT_TRANSFER) o si la salida de LPM3 es
+//!          comparable con la duracin de un byte a la velocidad del bus
+//!          configurada, y LPM3 en caso contrario. Para que la comparacin
+//!          use valores reales se debe llamar antes a
+//!          \a M24LC512_measureWakeupCost().
+//!
+//! \param Policy \b M24LC512_LPM_AUTO, \b M24LC512_LPM_0 o
+//!        \b M24LC512_LPM_3.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_setLowPowerPolicy(const uint8_t Policy);
+
+//*****************************************************************************
+//! \brief Mide el costo de salida de LPM0 y LPM3.
+//!
+//! \details \b Descripcin \n
+//!          Programa el Timer_A1, alimentado por SMCLK con pedido de reloj
+//!          habilitado, para interrumpir \b M24LC512_WAKEUP_PROBE_CYCLES
+//!          ciclos despus y entra en cada modo de bajo consumo. Al volver
+//!          se lee el contador y la diferencia con \b TA1CCR0 es la
+//!          cantidad de ciclos de SMCLK que tard la CPU en retomar la
+//!          ejecucin. Se debe repetir cada vez que cambia el perfil de reloj.
+//!          El Timer_A1 es de la librera (tambin lo usa
+//!          \a M24LC512_powerFlush()): la aplicacin no lo debe usar.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits de los registros \b CSCTL8, \b SR,
+//!            \b TA1CTL, \b TA1CCTL0 y \b TA1CCR0.
+//*****************************************************************************
+void M24LC512_measureWakeupCost(void);
+
+//*****************************************************************************
+//! \brief Devuelve el costo de salida medido de un modo de bajo consumo.
+//!
+//! \param Mode \b M24LC512_LPM_0 o \b M24LC512_LPM_3.
+//!
+//! \return Ciclos de SMCLK desde la interrupcin hasta la vuelta al programa.
+//*****************************************************************************
+uint16_t M24LC512_getWakeupCost(const uint8_t Mode);
+
 //*****************************************************************************
 //! \brief Configura el MCU para realizar una escritura.
 //!
@@ -287,16 +726,345 @@ void M24LC512_byteWrite(const uint16_t Address , const uint8_t Data);
 //!        bytes de datos.
 //! \param *Data Puntero donde se almacenarn los datos, que se quieren escribir
 //!        en la memoria.
+//!          Si una pgina empezara en \b M24LC512_SPARE_ADDRESS la escritura
+//!          sigue en la direccin 0 y se cuenta una sobreescritura en
+//!          \b countS, as el registro circular nunca pisa las pginas de
+//!          reserva. Una escritura que termina justo en esa direccin la
+//!          devuelve, para que una particin que llega al final detecte su
+//!          lmite.
+//!
 //! \param Size Cantidad de datos a escribir en la memoria.
 //!
-//! \return \c void.
+//! \return \c false si fall la verificacin y no se pudo reubicar la
+//!         pgina (ver \a M24LC512_setVerify()).
 //!
 //! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
 //!            \b UCB0TXBUF ,\b SR y \b UCB0IE.
 //*****************************************************************************
-void M24LC512_pageWrite(uint16_t* StartAddress , uint8_t *Data,
+bool M24LC512_pageWrite(uint16_t* StartAddress , const uint8_t *Data,
                         const uint16_t Size);
 
+//*****************************************************************************
+//! \brief Escribe un encabezado y sus datos dentro de una misma pgina.
+//!
+//! \details \b Descripcin \n
+//!          Enva en una sola transaccin I2C el sello de la pgina (si
+//!          \b Address es el comienzo de una pgina y el sello est
+//!          habilitado), el encabezado \b Frame y los datos, de modo que se
+//!          graban en un nico ciclo de escritura. Quien llama debe asegurar
+//!          que todo entra en lo que queda de la pgina. No escribe a partir
+//!          de \b M24LC512_SPARE_ADDRESS.
+//!
+//! \param *Address Direccin donde escribir, se devuelve la siguiente.
+//! \param *Frame Encabezado, de hasta \b M24LC512_FRAME_MAX bytes.
+//! \param FrameSize Tamao del encabezado.
+//! \param *Data Datos a escribir a continuacin del encabezado.
+//! \param Size Cantidad de datos.
+//!
+//! \return \c false si la direccin es de las pginas de reserva o si fall
+//!         la verificacin y no se pudo reubicar la pgina (ver
+//!         \a M24LC512_setVerify()).
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR y \b UCB0IE.
+//*****************************************************************************
+bool M24LC512_frameWrite(uint16_t *Address, const uint8_t *Frame,
+                         const uint8_t FrameSize, const uint8_t *Data,
+                         const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Escribe datos dentro de una pgina sin sello.
+//!
+//! \details \b Descripcin \n
+//!          Escribe \b Size bytes a partir de \b Address en una sola
+//!          transaccin, sin anteponer el sello de pgina aunque est
+//!          habilitado. Es la escritura de los mdulos que manejan pginas
+//!          completas en un lugar fijo (nivelacin de desgaste, tablas). Quien
+//!          llama debe asegurar que los datos no cruzan el lmite de la
+//!          pgina.
+//!
+//! \param Address Direccin donde escribir.
+//! \param *Data Datos a escribir.
+//! \param Size Cantidad de datos, hasta \b M24LC512_MAXPAGEWRITE.
+//!
+//! \return \c false si fall la verificacin y no se pudo reubicar la
+//!         pgina (ver \a M24LC512_setVerify()).
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR y \b UCB0IE.
+//*****************************************************************************
+bool M24LC512_pageProgram(const uint16_t Address, const uint8_t *Data,
+                          const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Escribe datos sin sello que pueden ocupar varias pginas.
+//!
+//! \details \b Descripcin \n
+//!          Divide los datos en el lmite de cada pgina y escribe cada parte
+//!          con \a M24LC512_pageProgram(). Si una parte falla se siguen
+//!          escribiendo las dems.
+//!
+//! \param Address Direccin donde escribir.
+//! \param *Data Datos a escribir.
+//! \param Size Cantidad de datos.
+//!
+//! \return \c false si fall alguna pgina.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR y \b UCB0IE.
+//*****************************************************************************
+bool M24LC512_rangeProgram(uint16_t Address, const uint8_t *Data, uint16_t Size);
+
+//*****************************************************************************
+//! \brief Habilita el sello de secuencia en cada pgina escrita.
+//!
+//! \details \b Descripcin \n
+//!          Con el sello habilitado, cada vez que \a M24LC512_pageWrite()
+//!          comienza a escribir una pgina antepone
+//!          \b M24LC512_STAMP_SIZE bytes con el nmero de secuencia
+//!          \b pageSequence de la cabecera, que luego se incrementa, y la
+//!          poca actual del registro. El
+//!          puntero devuelto ya saltea el sello. Permite recuperar el puntero
+//!          de la memoria con \a M24LC512_recoverHead() si se pierde la
+//!          cabecera. Toda la memoria se debe escribir con el sello
+//!          habilitado.
+//!
+//! \param Enable \c true para habilitar el sello.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_setPageStamp(const bool Enable);
+
+//*****************************************************************************
+//! \brief Habilita la verificacin de cada escritura.
+//!
+//! \details \b Descripcin \n
+//!          Con la verificacin habilitada, luego de cada ciclo de escritura
+//!          se releen los datos de a \b M24LC512_VERIFY_PIECE bytes y se
+//!          comparan con los enviados. Si no coinciden se reescriben hasta
+//!          \b M24LC512_VERIFY_RETRIES veces y, si siguen fallando, la
+//!          pgina completa (lo que tena ms los datos nuevos) se escribe
+//!          en la prxima pgina de reserva, se verifica, y se agrega a la
+//!          tabla de pginas defectuosas de la FRAM; si la reserva tambin
+//!          falla se descarta y se prueba la siguiente. Desde entonces las
+//!          escrituras y lecturas de esa pgina van a la reserva sin que se
+//!          entere quien llama.
+//!          Equivale a \a M24LC512_setVerifyPolicy() con
+//!          \b M24LC512_VERIFY_FULL o \b M24LC512_VERIFY_NONE, sin cambiar los
+//!          reintentos.
+//!          Ninguna escritura llega a las pginas de reserva: las
+//!          particiones y las zonas terminan antes, el registro de
+//!          \b memPointer vuelve a 0 en \b M24LC512_SPARE_ADDRESS y
+//!          \a M24LC512_frameWrite() rechaza esas direcciones.
+//!
+//! \param Enable \c true para habilitar la verificacin.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_setVerify(const bool Enable);
+
+//*****************************************************************************
+//! \brief Selecciona cmo se verifican las escrituras.
+//!
+//! \details \b Descripcin \n
+//!          Con \b M24LC512_VERIFY_FULL se comparan los datos reledos de a
+//!          \b M24LC512_VERIFY_PIECE bytes; con \b M24LC512_VERIFY_CRC se
+//!          relee todo el bloque en una sola lectura con start repetido,
+//!          pasando cada byte al mdulo CRC, y solo se compara el CRC16, ms
+//!          rpido y sin buffer. Si la verificacin falla la escritura se
+//!          repite hasta \b Retries veces y recin entonces se reubica la
+//!          pgina como en \a M24LC512_setVerify(). Cada flujo de datos
+//!          puede elegir su poltica y devolver la anterior al terminar.
+//!
+//! \param Policy \b M24LC512_VERIFY_NONE, \b M24LC512_VERIFY_CRC o
+//!        \b M24LC512_VERIFY_FULL.
+//! \param Retries Reintentos antes de reubicar la pgina.
+//!
+//! \return Poltica anterior.
+//*****************************************************************************
+uint8_t M24LC512_setVerifyPolicy(const uint8_t Policy, const uint8_t Retries);
+
+//*****************************************************************************
+//! \brief Escribe datos dentro de una pgina con una poltica propia.
+//!
+//! \details \b Descripcin \n
+//!          Igual que \a M24LC512_pageProgram() pero verifica con
+//!          \b Policy, sin cambiar la poltica del resto de las escrituras.
+//!
+//! \param Address Direccin donde escribir.
+//! \param *Data Datos a escribir.
+//! \param Size Cantidad de datos, hasta \b M24LC512_MAXPAGEWRITE.
+//! \param Policy Poltica de verificacin de esta escritura.
+//!
+//! \return \c false si no se pudo escribir correctamente (ver
+//!         \a M24LC512_writeResult()).
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE, \b CRCINIRES y
+//!            \b CRCDI.
+//*****************************************************************************
+bool M24LC512_pageProgramVerified(const uint16_t Address, const uint8_t *Data,
+                                  const uint16_t Size, const uint8_t Policy);
+
+//*****************************************************************************
+//! \brief Detiene las escrituras de varias pginas.
+//!
+//! \details \b Descripcin \n
+//!          Con \b Abort en \c true, \a M24LC512_pageWrite() no empieza otra
+//!          pgina: la que est en curso se termina completa (una pgina se
+//!          graba entera o no se graba) y devuelve \c false con
+//!          \b StartAddress despus de lo escrito. Se puede llamar desde una
+//!          interrupcin.
+//!
+//! \param Abort \c true para detener las escrituras.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_abortWrites(const bool Abort);
+
+//*****************************************************************************
+//! \brief Indica si la librera est esperando al bus I2C.
+//!
+//! \details \b Descripcin \n
+//!          Durante una transferencia la CPU duerme entre byte y byte y la
+//!          despierta la interrupcin del \b eUSCI_B0; lo mismo hace el
+//!          Timer_A1 en \a M24LC512_measureWakeupCost(). Una interrupcin
+//!          de la aplicacin que quiere despertar al programa solo lo debe
+//!          hacer si esta funcin devuelve \c false: de lo contrario el
+//!          programa seguira como si hubiera llegado el byte. Se puede
+//!          llamar desde una interrupcin.
+//!
+//! \return \c true si hay una espera de la librera en curso.
+//*****************************************************************************
+bool M24LC512_busBusy(void);
+
+//*****************************************************************************
+//! \brief Devuelve el resultado de la ltima escritura.
+//!
+//! \details \b Descripcin \n
+//!          Vale para la ltima llamada a \a M24LC512_pageWrite(),
+//!          \a M24LC512_frameWrite(), \a M24LC512_pageProgram() o
+//!          \a M24LC512_crcPageWrite(); si escribi varias pginas es el peor
+//!          resultado de todas.
+//!
+//! \return \b M24LC512_WRITE_OK, \b M24LC512_WRITE_RETRIED,
+//!         \b M24LC512_WRITE_REMAPPED o \b M24LC512_WRITE_FAILED.
+//*****************************************************************************
+uint8_t M24LC512_writeResult(void);
+
+//*****************************************************************************
+//! \brief Devuelve cuntas pginas de reserva se usaron.
+//!
+//! \return Cantidad de pginas reemplazadas o descartadas, hasta
+//!         \b M24LC512_SPARE_PAGES.
+//*****************************************************************************
+uint16_t M24LC512_badPageCount(void);
+
+//*****************************************************************************
+//! \brief Indica si un rango de pginas ya est en uso.
+//!
+//! \details \b Descripcin \n
+//!          El rango est en uso si pasa de \b M24LC512_SPARE_START o si se
+//!          superpone con una particin configurada o con una zona reservada.
+//!          La particin \b Partition y la zona \b Zone no se consideran,
+//!          as quien ya es dueo de las pginas puede volver a pedirlas;
+//!          con \b M24LC512_PARTITIONS o \b M24LC512_ZONES se consideran
+//!          todas.
+//!
+//! \param Partition Particin que no se considera.
+//! \param Zone Zona que no se considera.
+//! \param StartPage Primera pgina del rango.
+//! \param PageCount Cantidad de pginas del rango.
+//!
+//! \return \c true si alguna pgina del rango est en uso.
+//*****************************************************************************
+bool M24LC512_pagesTaken(const uint8_t Partition, const uint8_t Zone,
+                         const uint16_t StartPage, const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Reserva un rango de pginas para un mdulo.
+//!
+//! \details \b Descripcin \n
+//!          Guarda en la FRAM que las pginas desde \b StartPage hasta
+//!          \b StartPage + \b PageCount - 1 pertenecen a la zona \b Zone,
+//!          reemplazando el rango que tena antes. El rango no se puede
+//!          superponer con una particin ni con otra zona: como la particin
+//!          0 ocupa por defecto toda la memoria, primero se la debe achicar
+//!          con \a M24LC512_setPartition(). La tabla no se borra con la
+//!          cabecera. Con \b PageCount en cero se libera la zona.
+//!
+//! \param Zone Zona, menor a \b M24LC512_ZONES.
+//! \param StartPage Primera pgina de la zona.
+//! \param PageCount Cantidad de pginas de la zona.
+//!
+//! \return \c true si el rango estaba libre y se reserv.
+//*****************************************************************************
+bool M24LC512_reserveZone(const uint8_t Zone, const uint16_t StartPage, const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Indica cuntos bytes de sello ocupa una direccin.
+//!
+//! \param Address Direccin de la memoria.
+//!
+//! \return \b M24LC512_STAMP_SIZE si el sello est habilitado y la direccin
+//!         es el comienzo de una pgina, 0 en caso contrario.
+//*****************************************************************************
+uint8_t M24LC512_stampSize(const uint16_t Address);
+
+//*****************************************************************************
+//! \brief Recupera el puntero de la memoria a partir de los sellos de pgina.
+//!
+//! \details \b Descripcin \n
+//!          Las pginas escritas en la vuelta actual del registro circular
+//!          tienen sello igual al de la pgina 0 ms su nmero, mientras que
+//!          las de la vuelta anterior, las de una poca anterior o las nunca
+//!          escritas no. Se hace una
+//!          bsqueda binaria de la ltima pgina que cumple esa condicin
+//!          entre las \b M24LC512_SPARE_START primeras, sin entrar en las
+//!          pginas de repuesto, leyendo solo el sello de unas 10 pginas.
+//!          El puntero de la memoria y el nmero de secuencia de la
+//!          cabecera se colocan al inicio de la pgina siguiente (la pgina
+//!          0 si el registro lleg al final), se toma la
+//!          poca de la pgina 0 y se guarda la cabecera. El puntero de la
+//!          comunicacin no se modifica.
+//!
+//! \return Nuevo puntero de la memoria.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+uint16_t M24LC512_recoverHead(void);
+
+//*****************************************************************************
+//! \brief Indica si una pgina pertenece a la poca actual del registro.
+//!
+//! \details \b Descripcin \n
+//!          Lee el sello de la pgina y verifica que haya sido escrita con
+//!          sello y que su poca coincida con la de la cabecera. Las pginas
+//!          de pocas anteriores se deben tratar como vacas.
+//!
+//! \param Page Nmero de pgina.
+//!
+//! \return \c true si la pgina tiene datos de la poca actual.
+//*****************************************************************************
+bool M24LC512_pageIsCurrent(const uint16_t Page);
+
+//*****************************************************************************
+//! \brief Borra lgicamente el registro.
+//!
+//! \details \b Descripcin \n
+//!          En lugar de escribir las 512 pginas de la memoria (unos 2,5 s)
+//!          se incrementa la poca de la cabecera y se vuelven al inicio los
+//!          punteros de la memoria, de la comunicacin y de cada particin.
+//!          Los datos viejos siguen en la memoria pero sus pginas tienen una
+//!          poca anterior, por lo que no se confunden con los nuevos. Es lo
+//!          mismo que hace \a M24LC512_updateHeader() con el comando
+//!          \b M24LC512_FLAG_RESET.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_clearLog(void);
+
 //*****************************************************************************
 //! \brief Realiza una lectura de datos en la direccin actual en que se
 //!        encuentre la memoria.
@@ -394,6 +1162,8 @@ uint8_t M24LC512_randomRead(const uint16_t Address);
 //!          operacin. El puntero de direccin interno pasar automticamente
 //!          de la direccin FFFF a la direccin 0000 si el maestro reconoce
 //!          el byte recibido de la direccin de matriz FFFF.
+//!          La direccin y la lectura van en la misma transaccin, separadas
+//!          por un start repetido.
 //!
 //! \note Se enva la condicin de stop antes de almacenar el dato
 //!       sino la memoria enviara un datos de mas que genera problemas en
@@ -413,6 +1183,65 @@ uint8_t M24LC512_randomRead(const uint16_t Address);
 void M24LC512_sequentialRead(uint16_t Address, uint8_t *Data,
                              uint16_t Size);
 
+//*****************************************************************************
+//! \brief Escribe una pgina completa con su CRC16.
+//!
+//! \details \b Descripcin \n
+//!          Calcula con el mdulo CRC el CRC16 de los
+//!          \b M24LC512_CRC_DATA bytes de datos y lo graba en los ltimos
+//!          2 bytes de la pgina, en la misma transaccin que los datos.
+//!          Pasa por la verificacin y el reemplazo de pginas de
+//!          \a M24LC512_setVerify().
+//!
+//! \param Page Pgina a escribir, antes de las pginas de reserva.
+//! \param *Data \b M24LC512_CRC_DATA bytes de datos.
+//!
+//! \return \c true si se escribi la pgina.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE, \b CRCINIRES y \b CRCDI.
+//*****************************************************************************
+bool M24LC512_crcPageWrite(const uint16_t Page, const uint8_t *Data);
+
+//*****************************************************************************
+//! \brief Lee una pgina escrita con \a M24LC512_crcPageWrite() y verifica
+//!        su CRC16.
+//!
+//! \details \b Descripcin \n
+//!          Cada byte se pasa al mdulo CRC a medida que llega por el bus,
+//!          mientras se recibe el siguiente, as la verificacin no agrega
+//!          otra pasada sobre los datos.
+//!
+//! \param Page Pgina a leer, antes de las pginas de reserva.
+//! \param *Data Buffer de \b M24LC512_MAXPAGEWRITE bytes: los datos y, al
+//!        final, el CRC ledo.
+//!
+//! \return \c false si el CRC no coincide. Una pgina borrada no coincide.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE, \b CRCINIRES y
+//!            \b CRCDI.
+//*****************************************************************************
+bool M24LC512_crcPageRead(const uint16_t Page, uint8_t *Data);
+
+//*****************************************************************************
+//! \brief Contina un CRC16 con ms datos.
+//!
+//! \details \b Descripcin \n
+//!          Carga \b Crc como semilla del mdulo CRC y le pasa los datos. Como
+//!          parte del resultado anterior, el mdulo CRC se puede usar para
+//!          otra cosa entre dos llamadas.
+//!
+//! \param Crc Semilla o resultado de la llamada anterior.
+//! \param *Data Datos.
+//! \param Size Cantidad de datos.
+//!
+//! \return CRC16 acumulado.
+//!
+//! \attention Modifica los bits de los registros \b CRCINIRES y \b CRCDI.
+//*****************************************************************************
+uint16_t M24LC512_crcContinue(const uint16_t Crc, const uint8_t *Data, const uint16_t Size);
+
 //*****************************************************************************
 //! \brief Acknowledge Polling. La EEPROM no reconocera al MCU si hay un ciclo
 //!        de escritura en curso. Se puede usar para determinar cundo se
@@ -444,12 +1273,77 @@ void M24LC512_sequentialRead(uint16_t Address, uint8_t *Data,
 //*****************************************************************************
 void M24LC512_ackPolling(void);
 
+//*****************************************************************************
+//! \brief Habilita las escrituras en la FRAM.
+//!
+//! \details \b Descripcin \n
+//!          Quita la proteccin de escritura de la FRAM de datos (INFOA) y de
+//!          programa, donde se ubican las variables persistentes, y devuelve
+//!          el estado anterior para poder restaurarlo. Se puede anidar.
+//!
+//! \return Estado anterior de los bits \b DFWP y \b PFWP.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0.
+//*****************************************************************************
+uint8_t M24LC512_framUnlock(void);
+
+//*****************************************************************************
+//! \brief Restaura la proteccin de escritura de la FRAM.
+//!
+//! \param State Estado devuelto por \a M24LC512_framUnlock().
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0.
+//*****************************************************************************
+void M24LC512_framRestore(const uint8_t State);
+
+//*****************************************************************************
+//! \brief Carga la cabecera desde la FRAM.
+//!
+//! \details \b Descripcin \n
+//!          Verifica las dos copias guardadas a partir de
+//!          \b M24LC512_HEADER_ADDRESS (nmero mgico, versin y CRC16
+//!          calculado con el mdulo CRC) y copia a \b M24LC512_header la
+//!          vlida con mayor nmero de secuencia, sin necesidad de recorrer
+//!          la memoria externa. Si ninguna es vlida, por ejemplo en el
+//!          primer arranque o luego de cambiar el formato, se inicializa con
+//!          \a M24LC512_setinitValueHeader().
+//!
+//! \attention Modifica los bits de los registros \b CRCINIRES y \b CRCDI.
+//!
+//! \return \c true si se encontr una cabecera vlida, \c false si se tuvo
+//!         que inicializar.
+//*****************************************************************************
+bool M24LC512_loadHeader(void);
+
+//*****************************************************************************
+//! \brief Guarda la cabecera en la FRAM.
+//!
+//! \details \b Descripcin \n
+//!          Escribe \b M24LC512_header en la FRAM habilitando las escrituras
+//!          una sola vez, de modo que varios cambios en la copia de trabajo
+//!          se guardan juntos. Se incrementa el nmero de secuencia, se
+//!          calcula el CRC16 con el mdulo CRC y se escribe la copia
+//!          inactiva, que pasa a ser la activa. Si se corta la alimentacin
+//!          durante la escritura el CRC de esa copia no coincide y en el
+//!          prximo arranque se usa la anterior.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits de los registros \b SYSCFG0, \b CRCINIRES y
+//!            \b CRCDI.
+//*****************************************************************************
+void M24LC512_commitHeader(void);
+
 //*****************************************************************************
 //! \brief Establece los valores iniciales de la cabecera en la memoria.
 //!
 //! \details \b Descripcin \n
 //!          Se establecen las direcciones y valores iniciales de la cabecera
-//!          en la memoria externa.
+//!          en la memoria externa y se borra la fecha y hora de la ltima
+//!          medicin. La particin 0 ocupa las pginas hasta la primera zona
+//!          reservada con \a M24LC512_reserveZone().
 //!
 //! \return \c void.
 //*****************************************************************************
@@ -461,7 +1355,11 @@ void M24LC512_setinitValueHeader(void);
 //! \details \b Descripcin \n
 //!          Se encarga de ir actualizando la cabecera en memoria cada vez
 //!          que ocurre una escritura en la misma o cuando se reciba una
-//!          comando que asi lo requiera.
+//!          comando que asi lo requiera. Los comandos se indican colocando
+//!          \b M24LC512_FLAG_SENT o \b M24LC512_FLAG_RESET en el campo
+//!          \b flag de \b M24LC512_header antes de llamar a esta funcin.
+//!          Todos los cambios se guardan con un nico
+//!          \a M24LC512_commitHeader().
 //!
 //! \param currentAddress Direccion actual que apunta a la proxima direccin
 //!                       de la memoria a escribir.
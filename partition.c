@@ -0,0 +1,196 @@
+/*
+ * partition.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// partition.c - Particiones independientes del registro en la memoria 24LC512.
+//
+//*****************************************************************************
+
+#include "partition.h"
+//**********************************************************************************************************************************************************
+M24LC512_Partition *M24LC512_getPartition(const uint8_t Id)
+{
+    if((Id >= M24LC512_PARTITIONS) || (M24LC512_header.partition[Id].pageCount == 0))
+    {
+        return 0;
+    }
+
+    return &M24LC512_header.partition[Id];
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_partitionStart(const M24LC512_Partition *Part)
+{
+    return Part->startPage * M24LC512_MAXPAGEWRITE;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_partitionEnd(const M24LC512_Partition *Part)
+{
+    // La ultima pagina de la memoria termina en 0x10000, que en 16 bits es 0x0000 igual que el puntero devuelto por pageWrite.
+    return (uint16_t)((Part->startPage + Part->pageCount) * M24LC512_MAXPAGEWRITE);
+}
+//**********************************************************************************************************************************************************
+void M24LC512_readRange(const uint16_t Address, uint8_t *Data, const uint16_t Size)
+{
+    if(Size == 1)
+    {
+        Data[0] = M24LC512_randomRead(Address);    // La lectura secuencial necesita al menos 2 bytes
+    }
+    else
+    {
+        M24LC512_sequentialRead(Address, Data, Size);
+    }
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_setPartition(const uint8_t Id, const uint16_t StartPage, const uint16_t PageCount)
+{
+    M24LC512_Partition *part;
+
+    // El rango no se puede superponer con otra particion ni con una zona reservada por un modulo.
+    if((Id >= M24LC512_PARTITIONS) || M24LC512_pagesTaken(Id, M24LC512_ZONES, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    part = &M24LC512_header.partition[Id];
+    part->startPage = StartPage;
+    part->pageCount = PageCount;
+    part->head = M24LC512_partitionStart(part);
+    part->commPointer = part->head;
+    part->pending = 0;
+    part->wraps = 0;
+    part->flag = M24LC512_FLAG_NONE;
+    part->oldest = part->head;
+    part->oldestSequence = part->nextSequence;                    // Registro vacio
+
+    M24LC512_commitHeader();
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_append(const uint8_t Id, const uint8_t *Data, const uint16_t Size)
+{
+    M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint16_t remaining = Size;
+    uint16_t address;
+    uint16_t chunkSize;
+    uint32_t capacity;
+    bool ok;
+
+    if(part == 0)
+    {
+        return 0;
+    }
+
+    capacity = (uint32_t)part->pageCount * M24LC512_MAXPAGEWRITE;
+
+    while(remaining > 0)
+    {
+        // Se escribe de a una pagina para poder volver al inicio de la particion en el limite exacto.
+        address = part->head;
+        chunkSize = M24LC512_MAXPAGEWRITE - (address % M24LC512_MAXPAGEWRITE) - M24LC512_stampSize(address);
+        if(chunkSize > remaining)
+        {
+            chunkSize = remaining;
+        }
+
+        ok = M24LC512_pageWrite(&part->head, Data, chunkSize);
+
+        part->pending += (uint16_t)(part->head - address);      // Incluye el sello de la pagina si lo hubo
+
+        if(part->head == M24LC512_partitionEnd(part))
+        {
+            part->head = M24LC512_partitionStart(part);
+            part->wraps++;
+        }
+
+        if(part->pending > capacity)
+        {
+            // Se sobrescribieron datos sin enviar: el dato mas viejo que queda esta en el puntero de escritura.
+            part->flag = M24LC512_FLAG_DATA_LOST;
+            part->commPointer = part->head;
+            part->pending = capacity;
+        }
+
+        if(!ok)
+        {
+            break;                                              // El puntero ya quedo donde dejo la escritura
+        }
+
+        Data += chunkSize;
+        remaining -= chunkSize;
+    }
+
+    M24LC512_commitHeader();
+
+    return Size - remaining;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_export(const uint8_t Id, uint8_t *Data, const uint16_t Size)
+{
+    M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint16_t copied = 0;
+    uint16_t address;
+    uint16_t chunkSize;
+    uint8_t stampSize;
+
+    if(part == 0)
+    {
+        return 0;
+    }
+
+    address = part->commPointer;
+
+    while((copied < Size) && (part->pending > 0))
+    {
+        // El sello de la pagina no forma parte de los datos.
+        stampSize = M24LC512_stampSize(address);
+        address += stampSize;
+        part->pending -= stampSize;
+
+        chunkSize = M24LC512_MAXPAGEWRITE - (address % M24LC512_MAXPAGEWRITE);
+        if(chunkSize > (Size - copied))
+        {
+            chunkSize = Size - copied;
+        }
+        if(chunkSize > part->pending)
+        {
+            chunkSize = (uint16_t)part->pending;
+        }
+
+        if(chunkSize > 0)
+        {
+            M24LC512_readRange(address, &Data[copied], chunkSize);
+        }
+
+        copied += chunkSize;
+        part->pending -= chunkSize;
+        address += chunkSize;
+
+        if(address == M24LC512_partitionEnd(part))
+        {
+            address = M24LC512_partitionStart(part);
+        }
+    }
+
+    part->commPointer = address;
+
+    if(part->pending == 0)
+    {
+        part->flag = M24LC512_FLAG_NONE;                          // Se enviaron todos los datos, incluso los que quedaron luego de una perdida
+    }
+
+    M24LC512_commitHeader();
+
+    return copied;
+}
+//**********************************************************************************************************************************************************
+uint32_t M24LC512_getPending(const uint8_t Id)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+
+    return (part == 0) ? 0 : part->pending;
+}
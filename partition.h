@@ -0,0 +1,144 @@
+/**
+  * @file     partition.h
+  * @brief    Particiones independientes del registro en la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// partition.h - Particiones independientes del registro en la memoria 24LC512.
+//
+//*****************************************************************************
+
+#ifndef PARTITION_H_
+#define PARTITION_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "memory.h"
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura el rango de pginas de una particin.
+//!
+//! \details \b Descripcin \n
+//!          Asigna a la particin \b Id las pginas desde \b StartPage hasta
+//!          \b StartPage + \b PageCount - 1 y coloca el puntero de escritura
+//!          y el de la comunicacin al inicio del rango. El rango no se puede
+//!          superponer con el de otra particin ni con una zona reservada
+//!          con \a M24LC512_reserveZone(), por lo que para dividir la
+//!          memoria primero se debe achicar la particin 0, que por defecto
+//!          ocupa toda la memoria salvo las pginas de reserva, que ninguna
+//!          particin puede incluir. Con \b PageCount en cero se libera la
+//!          particin.
+//!
+//! \param Id Nmero de particin, menor a \b M24LC512_PARTITIONS.
+//! \param StartPage Primera pgina de la particin.
+//! \param PageCount Cantidad de pginas de la particin.
+//!
+//! \return \c true si el rango es vlido y se guard en la cabecera.
+//*****************************************************************************
+bool M24LC512_setPartition(const uint8_t Id, const uint16_t StartPage,
+                           const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Agrega datos al final de una particin.
+//!
+//! \details \b Descripcin \n
+//!          Escribe los datos a partir del puntero de escritura de la
+//!          particin con \a M24LC512_pageWrite(), pgina por pgina. Al
+//!          llegar al final del rango el puntero vuelve al inicio y se
+//!          incrementa el contador de vueltas. Si se sobrescriben datos que
+//!          todava no se enviaron se indica \b M24LC512_FLAG_DATA_LOST y el
+//!          puntero de la comunicacin pasa al dato ms viejo que qued.
+//!          Si falla la escritura de una pgina se detiene ah. La cabecera
+//!          se guarda una sola vez al final.
+//!
+//! \param Id Nmero de particin.
+//! \param *Data Datos a escribir.
+//! \param Size Cantidad de bytes a escribir.
+//!
+//! \return Cantidad de bytes escritos en las pginas que no fallaron, 0 si la
+//!         particin no est configurada.
+//*****************************************************************************
+uint16_t M24LC512_append(const uint8_t Id, const uint8_t *Data,
+                         const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Lee los datos pendientes de envo de una particin.
+//!
+//! \details \b Descripcin \n
+//!          Lee a partir del puntero de la comunicacin de la particin hasta
+//!          \b Size bytes o hasta alcanzar el puntero de escritura, salteando
+//!          los sellos de pgina, y avanza el puntero de la comunicacin. Al
+//!          leer todos los datos pendientes se borra el flag de prdida de
+//!          datos. Solo se leen las pginas de la particin pedida.
+//!
+//! \param Id Nmero de particin.
+//! \param *Data Buffer donde se guardan los datos ledos.
+//! \param Size Tamao del buffer.
+//!
+//! \return Cantidad de bytes ledos.
+//*****************************************************************************
+uint16_t M24LC512_export(const uint8_t Id, uint8_t *Data, const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Devuelve la cantidad de bytes pendientes de envo de una particin.
+//!
+//! \param Id Nmero de particin.
+//!
+//! \return Bytes entre el puntero de la comunicacin y el de escritura,
+//!         incluyendo los sellos de pgina.
+//*****************************************************************************
+uint32_t M24LC512_getPending(const uint8_t Id);
+
+//*****************************************************************************
+//! \brief Devuelve la entrada de la tabla de particiones.
+//!
+//! \param Id Nmero de particin.
+//!
+//! \return Puntero a la entrada en la copia de la cabecera en RAM, o 0 si la
+//!         particin no est configurada.
+//*****************************************************************************
+M24LC512_Partition *M24LC512_getPartition(const uint8_t Id);
+
+//*****************************************************************************
+//! \brief Devuelve la primera direccin de una particin.
+//!
+//! \param *Part Entrada de la tabla de particiones.
+//!
+//! \return Direccin del comienzo de la primera pgina.
+//*****************************************************************************
+uint16_t M24LC512_partitionStart(const M24LC512_Partition *Part);
+
+//*****************************************************************************
+//! \brief Devuelve la direccin siguiente al final de una particin.
+//!
+//! \param *Part Entrada de la tabla de particiones.
+//!
+//! \return Direccin siguiente a la ltima pgina, 0x0000 si la particin
+//!         termina al final de la memoria.
+//*****************************************************************************
+uint16_t M24LC512_partitionEnd(const M24LC512_Partition *Part);
+
+//*****************************************************************************
+//! \brief Lee un rango de la memoria de cualquier tamao.
+//!
+//! \details \b Descripcin \n
+//!          Usa \a M24LC512_randomRead() para un byte y
+//!          \a M24LC512_sequentialRead() para ms.
+//!
+//! \param Address Direccin de inicio.
+//! \param *Data Buffer donde se guardan los datos ledos.
+//! \param Size Cantidad de bytes, mayor a cero.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_readRange(const uint16_t Address, uint8_t *Data,
+                        const uint16_t Size);
+
+#endif /* PARTITION_H_ */
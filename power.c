@@ -0,0 +1,159 @@
+/*
+ * power.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// power.c - Aviso de cada de la alimentacin y vaciado de la memoria
+//           24LC512.
+//
+//*****************************************************************************
+
+#include <stddef.h>
+
+#include "power.h"
+
+// El registro de vaciados se guarda en la FRAM principal: se lee al volver la alimentacion.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(powerLog)
+static M24LC512_PowerLog powerLog = {0};
+#elif defined(__GNUC__)
+static M24LC512_PowerLog powerLog __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+static volatile bool powerFail = false;                         // La ultima medicion quedo por debajo del umbral
+static uint16_t powerFailLevel;                                 // Lectura del ADC a partir de la cual se da el aviso
+static uint16_t powerRearmLevel;                                // Lectura por debajo de la cual se vuelve a escribir
+static void (*powerFlushData)(void) = NULL;                     // Vaciado de los datos de la aplicacion
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_powerMeasure(void)
+{
+    uint16_t ctl0;
+    uint16_t ctl1;
+    uint16_t ctl2;
+    uint16_t mctl0;
+    uint16_t ie;
+    uint16_t reading;
+
+    // El ADC es de la aplicacion: si esta convirtiendo o todavia no leyo su resultado no se lo toca.
+    if((ADCCTL1 & ADCBUSY) || (ADCIFG & ADCIFG0))
+    {
+        return M24LC512_POWER_NO_READING;
+    }
+
+    ctl0 = ADCCTL0;
+    ctl1 = ADCCTL1;
+    ctl2 = ADCCTL2;
+    mctl0 = ADCMCTL0;
+    ie = ADCIE;
+
+    // Al bajar AVCC la lectura de la referencia fija sube: 1,5 V * 1023 / AVCC. Con MODOSC la conversion dura unos
+    // 55 us y el oscilador solo se enciende mientras convierte.
+    ADCIE = 0;
+    ADCCTL0 &= ~ADCENC;                                             // La configuracion solo cambia con ADCENC = 0
+    ADCCTL0 = ADCSHT_8 | ADCON;
+    ADCCTL1 = ADCSHS_0 | ADCSHP | ADCSSEL_0;
+    ADCCTL2 = ADCRES_1;
+    ADCMCTL0 = ADCSREF_0 | ADCINCH_13;
+    ADCCTL0 |= ADCENC | ADCSC;
+
+    while(!(ADCIFG & ADCIFG0));
+    reading = ADCMEM0;                                              // Borra ADCIFG0
+
+    // Se devuelve la configuracion de la aplicacion, con ADCENC al final.
+    ADCCTL0 &= ~ADCENC;
+    ADCCTL1 = ctl1;
+    ADCCTL2 = ctl2;
+    ADCMCTL0 = mctl0;
+    ADCIE = ie;
+    ADCCTL0 = ctl0;
+
+    return reading;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_powerInit(const uint16_t ThresholdMv, void (*Flush)(void))
+{
+    powerFlushData = Flush;
+    powerFailLevel = (uint16_t)((M24LC512_POWER_REF_MV * M24LC512_POWER_ADC_FULL) / ThresholdMv);
+    powerRearmLevel = (uint16_t)((M24LC512_POWER_REF_MV * M24LC512_POWER_ADC_FULL) /
+                                 (ThresholdMv + M24LC512_POWER_HYSTERESIS_MV));
+    powerFail = false;
+    M24LC512_abortWrites(false);
+
+    PMM_enableInternalReference();
+    while(PMM_getBufferedBandgapVoltageStatus() == PMM_REFBG_NOTREADY);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_powerPoll(void)
+{
+    uint16_t reading = M24LC512_powerMeasure();
+
+    if(reading == M24LC512_POWER_NO_READING)
+    {
+        return powerFail;
+    }
+
+    if(!powerFail && (reading >= powerFailLevel))
+    {
+        // La escritura en curso termina su pagina y el lazo principal ve el aviso con M24LC512_powerFailing().
+        powerFail = true;
+        M24LC512_abortWrites(true);
+    }
+    else if(powerFail && (reading < powerRearmLevel))
+    {
+        // La caida no llego a cortar la alimentacion: se vuelve a escribir con normalidad.
+        powerFail = false;
+        M24LC512_abortWrites(false);
+    }
+
+    return powerFail;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_powerFailing(void)
+{
+    return powerFail;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_powerFlush(void)
+{
+    uint16_t ticks;
+    uint8_t state;
+
+    TA1CTL = TASSEL__ACLK | MC__CONTINUOUS | TACLR;
+
+    // La aplicacion escribe lo que tenga pendiente; despues ya no se empieza ninguna pagina mas.
+    if(powerFlushData != NULL)
+    {
+        M24LC512_abortWrites(false);
+        powerFlushData();
+        M24LC512_abortWrites(true);
+    }
+
+    M24LC512_commitHeader();
+
+    ticks = TA1R;
+    TA1CTL = MC__STOP;
+
+    state = M24LC512_framUnlock();
+
+    powerLog.events++;
+    powerLog.lastTicks = ticks;
+    if(ticks > powerLog.maxTicks)
+    {
+        powerLog.maxTicks = ticks;
+    }
+
+    M24LC512_framRestore(state);
+
+    // Si la tension ya se recupero no se espera a la proxima medicion para volver a escribir.
+    M24LC512_powerPoll();
+}
+//**********************************************************************************************************************************************************
+void M24LC512_powerStats(M24LC512_PowerLog *Log)
+{
+    *Log = powerLog;
+}
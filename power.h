@@ -0,0 +1,180 @@
+/**
+  * @file     power.h
+  * @brief    Aviso de cada de la alimentacin y vaciado de la memoria
+  *           24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// power.h - Aviso de cada de la alimentacin y vaciado de la memoria
+//           24LC512.
+//
+//*****************************************************************************
+
+#ifndef POWER_H_
+#define POWER_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "memory.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Tensin de aviso por defecto en mV. Deja margen sobre el mnimo
+//!          del \b 24LC512 (1,8 V) para terminar el vaciado.
+//*****************************************************************************
+#define M24LC512_POWER_DEFAULT_MV   2200
+
+//*****************************************************************************
+//! \details Referencia interna que se mide contra AVCC, en mV, y fondo de
+//!          escala del ADC de 10 bits.
+//*****************************************************************************
+//! @name Medicin de la alimentacin
+//! @{
+#define M24LC512_POWER_REF_MV       1500UL
+#define M24LC512_POWER_ADC_FULL     1023UL
+//! @}
+
+//*****************************************************************************
+//! \details Histresis en mV: despus de un aviso las escrituras se vuelven a
+//!          habilitar recin cuando AVCC supera el umbral ms este valor.
+//*****************************************************************************
+#define M24LC512_POWER_HYSTERESIS_MV 100
+
+//*****************************************************************************
+//! \details Medicin no realizada porque el ADC estaba en uso. Con AVCC de
+//!          hasta 3,6 V la lectura de la referencia nunca es menor a 426.
+//*****************************************************************************
+#define M24LC512_POWER_NO_READING   0
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Vaciados por cada de tensin, guardados en la FRAM. Los tiempos
+//!          estn en ciclos de ACLK (30,5 us) y miden lo que necesita el
+//!          vaciado, es decir el tiempo que debe sostener la alimentacin el
+//!          capacitor de respaldo despus del aviso.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t events;        //!< Vaciados realizados.
+    uint16_t lastTicks;     //!< Duracin del ltimo vaciado.
+    uint16_t maxTicks;      //!< Duracin del vaciado ms largo.
+} M24LC512_PowerLog;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Habilita el aviso de cada de la alimentacin.
+//!
+//! \details \b Descripcin \n
+//!          Guarda la funcin de vaciado y los niveles de aviso y de
+//!          rehabilitacin que corresponden a \b ThresholdMv y enciende la
+//!          referencia interna de 1,5 V. No usa ningn temporizador ni
+//!          interrupcin: las mediciones las hace
+//!          \a M24LC512_powerPoll(). Se llama despus de desbloquear los
+//!          puertos (\b LOCKLPM5).
+//!
+//! \param ThresholdMv Tensin de aviso en mV, por ejemplo
+//!        \b M24LC512_POWER_DEFAULT_MV.
+//! \param *Flush Funcin de la aplicacin que escribe sus datos pendientes
+//!        (a lo sumo una pgina), o \c NULL.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits del registro \b PMMCTL2.
+//*****************************************************************************
+void M24LC512_powerInit(const uint16_t ThresholdMv, void (*Flush)(void));
+
+//*****************************************************************************
+//! \brief Mide la alimentacin y actualiza el aviso.
+//!
+//! \details \b Descripcin \n
+//!          El \b MSP430FR4133 no tiene interrupcin del SVS (solo reset),
+//!          as que se convierte la referencia interna de 1,5 V contra AVCC
+//!          con MODOSC (~55 us, esperando el resultado). El ADC se comparte
+//!          con la aplicacin: se guardan y se devuelven \b ADCCTL0,
+//!          \b ADCCTL1, \b ADCCTL2, \b ADCMCTL0 y \b ADCIE, y si el ADC
+//!          est convirtiendo o tiene un resultado sin leer no se mide.
+//!          Si AVCC baj de \b ThresholdMv marca el aviso y detiene las
+//!          escrituras de varias pginas en el prximo lmite de pgina (ver
+//!          \a M24LC512_abortWrites()). Si despus de un aviso AVCC supera
+//!          \b ThresholdMv + \b M24LC512_POWER_HYSTERESIS_MV borra el
+//!          aviso y vuelve a habilitar las escrituras.
+//!          Se llama peridicamente, por ejemplo desde el lazo principal o
+//!          desde la interrupcin de un temporizador de la aplicacin; el
+//!          perodo es la demora del aviso. No despierta al programa: una
+//!          interrupcin que quiera hacerlo al recibir \c true debe
+//!          consultar antes \a M24LC512_busBusy().
+//!
+//! \return \c true si hay un aviso de cada de la alimentacin.
+//!
+//! \attention Modifica los bits de los registros \b ADCCTL0, \b ADCCTL1,
+//!            \b ADCCTL2, \b ADCMCTL0, \b ADCIE y \b ADCIFG, y los
+//!            devuelve a su valor.
+//*****************************************************************************
+bool M24LC512_powerPoll(void);
+
+//*****************************************************************************
+//! \brief Indica si lleg el aviso de cada de la alimentacin.
+//!
+//! \details \b Descripcin \n
+//!          Devuelve el resultado de la ltima \a M24LC512_powerPoll() sin
+//!          medir. Se consulta en el lazo principal; si es \c true se llama a
+//!          \a M24LC512_powerFlush() antes de cualquier otra cosa. Para no
+//!          perder un aviso que llega justo antes de dormir, se consulta
+//!          con las interrupciones deshabilitadas y se entra en bajo consumo
+//!          habilitndolas en la misma instruccin.
+//!
+//! \return \c true si la tensin baj del umbral.
+//*****************************************************************************
+bool M24LC512_powerFailing(void);
+
+//*****************************************************************************
+//! \brief Vaca los datos pendientes y guarda la cabecera.
+//!
+//! \details \b Descripcin \n
+//!          La escritura en curso ya termin su pgina. Se llama a la funcin
+//!          de la aplicacin, se vuelven a detener las escrituras y se guarda
+//!          la cabecera en la FRAM con \a M24LC512_commitHeader(). La
+//!          duracin se mide con el Timer_A1, que es de la librera (ver
+//!          \a M24LC512_measureWakeupCost()), y se guarda en la FRAM.
+//!          Con SCL a 400 kHz el peor caso es la pgina en curso (~8 ms), la
+//!          pgina de la aplicacin (~8 ms) y la cabecera (< 0,1 ms), ms la
+//!          demora del aviso (hasta ~5 ms): unos 21 ms. Con unos 5 mA entre
+//!          el MCU y la memoria y una cada de 2,2 V a 1,8 V hacen falta al
+//!          menos 5 mA * 21 ms / 0,4 V = 263 uF de respaldo; el valor
+//!          medido en \b maxTicks es el que se debe usar para el diseo.
+//!          La demora de 5 ms supone llamar a \a M24LC512_powerPoll() cada
+//!          5 ms.
+//!          Al final se mide de nuevo con \a M24LC512_powerPoll(): si la
+//!          cada se recuper (umbral ms \b M24LC512_POWER_HYSTERESIS_MV)
+//!          se borra el aviso y se vuelven a habilitar las escrituras; si
+//!          no, quedan detenidas y el programa debe dormir hasta que se
+//!          corte la alimentacin o una medicin posterior las rehabilite.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE, \b SYSCFG0, \b TA1CTL, \b CRCINIRES,
+//!            \b CRCDI y los del ADC de \a M24LC512_powerPoll().
+//*****************************************************************************
+void M24LC512_powerFlush(void);
+
+//*****************************************************************************
+//! \brief Devuelve el registro de vaciados.
+//!
+//! \param *Log Devuelve la cantidad y la duracin de los vaciados.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_powerStats(M24LC512_PowerLog *Log);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,400 @@
+/*
+ * record.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// record.c - Registro circular de mensajes con encabezado en la memoria 24LC512.
+//
+//*****************************************************************************
+
+#include <string.h>
+
+#include "record.h"
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_recordNextPage(const M24LC512_Partition *Part, const uint16_t Address)
+{
+    uint16_t next = Address - (Address % M24LC512_MAXPAGEWRITE) + M24LC512_MAXPAGEWRITE;
+
+    return (next == M24LC512_partitionEnd(Part)) ? M24LC512_partitionStart(Part) : next;
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_recordSkip(const M24LC512_Partition *Part, const uint16_t Address, const uint8_t Length)
+{
+    uint16_t next = Address + M24LC512_RECORD_FRAME_SIZE + Length;
+
+    return (next == M24LC512_partitionEnd(Part)) ? M24LC512_partitionStart(Part) : next;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_recordCheck(const uint8_t *Frame, const uint8_t *Prefix, const uint8_t PrefixSize,
+                                   const uint8_t *Data, const uint8_t Length)
+{
+    uint16_t crc;
+    uint8_t i;
+
+    CRC_setSeed(CRC_BASE, M24LC512_RECORD_CRC_SEED);
+
+    // Se verifican la longitud, el numero de secuencia y los datos (prefijo incluido).
+    for(i = 0 ; i < (M24LC512_RECORD_FRAME_SIZE - 1) ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Frame[i]);
+    }
+    for(i = 0 ; i < PrefixSize ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Prefix[i]);
+    }
+    for(i = 0 ; i < Length ; i++)
+    {
+        CRC_set8BitData(CRC_BASE, Data[i]);
+    }
+
+    crc = CRC_getResult(CRC_BASE);
+
+    return (uint8_t)(crc ^ (crc >> 8));
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_recordLocate(const M24LC512_Partition *Part, uint16_t *Address, uint16_t *Sequence,
+                                  const uint16_t Remaining, uint8_t *Frame)
+{
+    uint16_t address = *Address;
+    uint16_t sequence;
+    uint16_t room;
+    uint16_t jumps;
+
+    // Si el registro esperado no esta en la direccion se busca al comienzo de las paginas siguientes, ya que cuando un
+    // registro no entra en una pagina se escribe en la siguiente. Se acepta un numero de secuencia posterior al esperado
+    // para poder seguir si se dao un encabezado; los de la vuelta anterior quedan fuera de la ventana.
+    for(jumps = 0 ; jumps <= Part->pageCount ; jumps++)
+    {
+        address += M24LC512_stampSize(address);
+        room = M24LC512_MAXPAGEWRITE - (address % M24LC512_MAXPAGEWRITE);
+
+        if(room > M24LC512_RECORD_FRAME_SIZE)
+        {
+            M24LC512_sequentialRead(address, Frame, M24LC512_RECORD_FRAME_SIZE);
+            sequence = ((uint16_t)Frame[1] << 8) | Frame[2];
+
+            if((Frame[0] != 0) && (Frame[0] <= (room - M24LC512_RECORD_FRAME_SIZE)) &&
+               ((uint16_t)(sequence - *Sequence) < Remaining))
+            {
+                *Address = address;
+                *Sequence = sequence;
+                return true;
+            }
+        }
+
+        address = M24LC512_recordNextPage(Part, address);
+    }
+
+    return false;
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_recordEvict(M24LC512_Partition *Part, const uint16_t Address)
+{
+    uint8_t frame[M24LC512_RECORD_FRAME_SIZE];
+    uint16_t page = M24LC512_recordNextPage(Part, Address);
+    uint16_t address = page + M24LC512_stampSize(page);
+    uint16_t sequence;
+
+    // Se descartan los registros de la pagina que se va a sobrescribir: el mas viejo pasa a ser el primero de la siguiente.
+    Part->oldest = page;
+
+    if(page != Address)
+    {
+        M24LC512_sequentialRead(address, frame, M24LC512_RECORD_FRAME_SIZE);
+        sequence = ((uint16_t)frame[1] << 8) | frame[2];
+
+        if((uint16_t)(sequence - Part->oldestSequence) < (uint16_t)(Part->nextSequence - Part->oldestSequence))
+        {
+            Part->oldestSequence = sequence;
+            return;
+        }
+    }
+
+    // Particion de una sola pagina o encabezado ilegible: el registro queda vacio.
+    Part->oldest = Address;
+    Part->oldestSequence = Part->nextSequence;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordAppend(const uint8_t Id, const uint8_t *Record, const uint8_t Length)
+{
+    return M24LC512_recordAppendPrefixed(Id, 0, 0, Record, Length, 0);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordAppendPrefixed(const uint8_t Id, const uint8_t *Prefix, const uint8_t PrefixSize,
+                                   const uint8_t *Record, const uint8_t Length, uint16_t *Address)
+{
+    M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint8_t frame[M24LC512_FRAME_MAX];
+    uint16_t address;
+    uint16_t room;
+    uint8_t i;
+    bool ok;
+
+    if((part == 0) || (PrefixSize > M24LC512_RECORD_PREFIX_MAX) ||
+       ((PrefixSize + Length) == 0) || ((PrefixSize + Length) > M24LC512_RECORD_MAX))
+    {
+        return false;
+    }
+
+    address = part->head;
+    room = M24LC512_MAXPAGEWRITE - (address % M24LC512_MAXPAGEWRITE) - M24LC512_stampSize(address);
+
+    if(room < (M24LC512_RECORD_FRAME_SIZE + PrefixSize + Length))
+    {
+        // Los registros no cruzan el limite de una pagina.
+        address = M24LC512_recordNextPage(part, address);
+        if(address == M24LC512_partitionStart(part))
+        {
+            part->wraps++;
+        }
+    }
+
+    if(part->oldestSequence == part->nextSequence)
+    {
+        part->oldest = address;
+    }
+    else if(((address % M24LC512_MAXPAGEWRITE) == 0) &&
+            ((address / M24LC512_MAXPAGEWRITE) == (part->oldest / M24LC512_MAXPAGEWRITE)))
+    {
+        M24LC512_recordEvict(part, address);
+    }
+
+    if(Address != 0)
+    {
+        *Address = address + M24LC512_stampSize(address);
+    }
+
+    frame[0] = PrefixSize + Length;
+    frame[1] = (uint8_t)(part->nextSequence >> 8);
+    frame[2] = (uint8_t)part->nextSequence;
+    frame[3] = M24LC512_recordCheck(frame, Prefix, PrefixSize, Record, Length);
+
+    // El prefijo viaja junto al encabezado, asi no hace falta copiar el registro a un buffer.
+    for(i = 0 ; i < PrefixSize ; i++)
+    {
+        frame[M24LC512_RECORD_FRAME_SIZE + i] = Prefix[i];
+    }
+
+    // Aunque falle la verificacion el registro ocupa su lugar: la lectura lo descarta por el control.
+    ok = M24LC512_frameWrite(&address, frame, M24LC512_RECORD_FRAME_SIZE + PrefixSize, Record, Length);
+
+    if(address == M24LC512_partitionEnd(part))
+    {
+        address = M24LC512_partitionStart(part);
+        part->wraps++;
+    }
+
+    part->head = address;
+    part->nextSequence++;
+
+    M24LC512_commitHeader();
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordBegin(const uint8_t Id, M24LC512_RecordIterator *Iterator)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+
+    if(part == 0)
+    {
+        return false;
+    }
+
+    Iterator->partition = Id;
+    Iterator->address = part->oldest;
+    Iterator->sequence = part->oldestSequence;
+    Iterator->remaining = part->nextSequence - part->oldestSequence;
+    Iterator->errors = 0;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordSeek(const uint8_t Id, M24LC512_RecordIterator *Iterator, const uint16_t Address,
+                         const uint16_t Sequence)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+
+    // Solo se puede posicionar en un registro que todavia este en la memoria.
+    if((part == 0) ||
+       ((uint16_t)(Sequence - part->oldestSequence) >= (uint16_t)(part->nextSequence - part->oldestSequence)))
+    {
+        return false;
+    }
+
+    Iterator->partition = Id;
+    Iterator->address = Address;
+    Iterator->sequence = Sequence;
+    Iterator->remaining = part->nextSequence - Sequence;
+    Iterator->errors = 0;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordNext(M24LC512_RecordIterator *Iterator, uint8_t *Data, uint8_t *Length)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Iterator->partition);
+    uint8_t frame[M24LC512_RECORD_FRAME_SIZE];
+    uint16_t expected;
+
+    if(part == 0)
+    {
+        return false;
+    }
+
+    while(Iterator->remaining > 0)
+    {
+        expected = Iterator->sequence;
+
+        if(!M24LC512_recordLocate(part, &Iterator->address, &Iterator->sequence, Iterator->remaining, frame))
+        {
+            Iterator->errors += Iterator->remaining;
+            Iterator->remaining = 0;
+            break;
+        }
+
+        // Los registros que no se encontraron se cuentan como errores.
+        Iterator->errors += Iterator->sequence - expected;
+        Iterator->remaining -= Iterator->sequence - expected;
+
+        M24LC512_readRange(Iterator->address + M24LC512_RECORD_FRAME_SIZE, Data, frame[0]);
+
+        Iterator->address = M24LC512_recordSkip(part, Iterator->address, frame[0]);
+        Iterator->sequence++;
+        Iterator->remaining--;
+
+        if(frame[3] == M24LC512_recordCheck(frame, 0, 0, Data, frame[0]))
+        {
+            *Length = frame[0];
+            return true;
+        }
+
+        Iterator->errors++;
+    }
+
+    return false;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordFetch(const uint8_t Id, const uint16_t Address, const uint16_t Sequence, uint8_t *Data,
+                          const uint8_t Length)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint8_t frame[M24LC512_RECORD_FRAME_SIZE];
+
+    // Un registro descartado puede estar sobrescrito aunque la direccion se lea bien.
+    if((part == 0) ||
+       ((uint16_t)(Sequence - part->oldestSequence) >= (uint16_t)(part->nextSequence - part->oldestSequence)))
+    {
+        return false;
+    }
+
+    // El registro nunca cruza una pagina: encabezado y datos salen en una sola lectura.
+    M24LC512_readRange(Address, Data, M24LC512_RECORD_FRAME_SIZE + Length);
+
+    memcpy(frame, Data, M24LC512_RECORD_FRAME_SIZE);
+    memmove(Data, &Data[M24LC512_RECORD_FRAME_SIZE], Length);
+
+    return (frame[0] == Length) && ((((uint16_t)frame[1] << 8) | frame[2]) == Sequence) &&
+           (frame[3] == M24LC512_recordCheck(frame, 0, 0, Data, Length));
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_recordTrim(const uint8_t Id, const uint16_t Count)
+{
+    M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint8_t frame[M24LC512_RECORD_FRAME_SIZE];
+    uint16_t address;
+    uint16_t sequence;
+    uint16_t first;
+
+    if(part == 0)
+    {
+        return 0;
+    }
+
+    address = part->oldest;
+    sequence = part->oldestSequence;
+    first = sequence;
+
+    // Solo se leen los encabezados para encontrar el comienzo del registro que pasa a ser el mas viejo.
+    while(((uint16_t)(sequence - first) < Count) && (sequence != part->nextSequence))
+    {
+        if(!M24LC512_recordLocate(part, &address, &sequence, part->nextSequence - sequence, frame))
+        {
+            sequence = part->nextSequence;
+            break;
+        }
+
+        address = M24LC512_recordSkip(part, address, frame[0]);
+        sequence++;
+    }
+
+    part->oldest = (sequence == part->nextSequence) ? part->head : address;
+    part->oldestSequence = sequence;
+
+    M24LC512_commitHeader();
+
+    return sequence - first;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_recordTrimPage(const uint8_t Id)
+{
+    M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint8_t frame[M24LC512_RECORD_FRAME_SIZE];
+    uint16_t page;
+    uint16_t address;
+    uint16_t sequence;
+    uint16_t first;
+
+    if((part == 0) || (part->oldestSequence == part->nextSequence))
+    {
+        return 0;
+    }
+
+    first = part->oldestSequence;
+    page = part->oldest - (part->oldest % M24LC512_MAXPAGEWRITE);
+    address = M24LC512_recordNextPage(part, page);
+    sequence = first;
+
+    // El primer registro de la pagina siguiente esta siempre despues del sello, donde lo busca recordLocate().
+    if((page != (part->head - (part->head % M24LC512_MAXPAGEWRITE))) && (address != part->head) &&
+       M24LC512_recordLocate(part, &address, &sequence, part->nextSequence - first, frame))
+    {
+        part->oldest = address;
+        part->oldestSequence = sequence;
+    }
+    else
+    {
+        part->oldest = part->head;                              // No quedan registros fuera de la pagina
+        part->oldestSequence = part->nextSequence;
+    }
+
+    M24LC512_commitHeader();
+
+    return part->oldestSequence - first;
+}
+//**********************************************************************************************************************************************************
+uint16_t M24LC512_recordCount(const uint8_t Id)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+
+    return (part == 0) ? 0 : (uint16_t)(part->nextSequence - part->oldestSequence);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_recordStartsPage(const uint8_t Id, const uint8_t Length)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(Id);
+    uint16_t offset;
+
+    if(part == 0)
+    {
+        return false;
+    }
+
+    // Misma decision que M24LC512_recordAppendPrefixed(): si no entra en la pagina se escribe al comienzo de la siguiente.
+    offset = part->head % M24LC512_MAXPAGEWRITE;
+
+    return (offset == 0) || ((M24LC512_MAXPAGEWRITE - offset) < (M24LC512_RECORD_FRAME_SIZE + Length));
+}
@@ -0,0 +1,235 @@
+/**
+  * @file     record.h
+  * @brief    Registro circular de mensajes con encabezado en la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// record.h - Registro circular de mensajes con encabezado en la memoria 24LC512.
+//
+//*****************************************************************************
+
+#ifndef RECORD_H_
+#define RECORD_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "partition.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Tamao del encabezado de cada registro: longitud, nmero de
+//!          secuencia (2 bytes) y byte de verificacin.
+//*****************************************************************************
+#define M24LC512_RECORD_FRAME_SIZE  4
+
+//*****************************************************************************
+//! \details Tamao mximo de un registro. Los registros no cruzan el lmite
+//!          de una pgina, por lo que deben entrar junto con el sello y el
+//!          encabezado en una pgina.
+//*****************************************************************************
+#define M24LC512_RECORD_MAX         (M24LC512_MAXPAGEWRITE - M24LC512_STAMP_SIZE - M24LC512_RECORD_FRAME_SIZE)
+
+//*****************************************************************************
+//! \details Tamao mximo del prefijo de \a M24LC512_recordAppendPrefixed().
+//*****************************************************************************
+#define M24LC512_RECORD_PREFIX_MAX  (M24LC512_FRAME_MAX - M24LC512_RECORD_FRAME_SIZE)
+
+//*****************************************************************************
+//! \details Semilla del CRC16 usado para el byte de verificacin.
+//*****************************************************************************
+#define M24LC512_RECORD_CRC_SEED    0xFFFF
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Posicin de una lectura de registros, del ms viejo al ms nuevo.
+//*****************************************************************************
+typedef struct
+{
+    uint8_t partition;      //!< Particin que se recorre.
+    uint16_t address;       //!< Direccin del prximo registro.
+    uint16_t sequence;      //!< Nmero de secuencia del prximo registro.
+    uint16_t remaining;     //!< Registros que faltan leer.
+    uint16_t errors;        //!< Registros salteados por fallar la verificacin.
+} M24LC512_RecordIterator;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Agrega un registro al final de una particin.
+//!
+//! \details \b Descripcin \n
+//!          Escribe el encabezado (longitud, nmero de secuencia y byte de
+//!          verificacin calculado con el mdulo CRC) y los datos en una
+//!          sola escritura con \a M24LC512_frameWrite(). Si el registro no
+//!          entra en lo que queda de la pgina se escribe al comienzo de la
+//!          siguiente. Al volver a una pgina que contiene el registro ms
+//!          viejo se descartan los registros de esa pgina y se actualiza la
+//!          direccin del ms viejo en la cabecera. Una particin se usa para
+//!          registros o para \a M24LC512_append(), no para ambos.
+//!
+//! \param Id Nmero de particin.
+//! \param *Record Datos del registro.
+//! \param Length Tamao del registro, de 1 a \b M24LC512_RECORD_MAX.
+//!
+//! \return \c true si se escribi y verific el registro.
+//*****************************************************************************
+bool M24LC512_recordAppend(const uint8_t Id, const uint8_t *Record,
+                           const uint8_t Length);
+
+//*****************************************************************************
+//! \brief Agrega un registro formado por un prefijo y datos.
+//!
+//! \details \b Descripcin \n
+//!          Igual que \a M24LC512_recordAppend(), pero el registro guardado
+//!          es \b Prefix seguido de \b Record, sin copiarlos a un buffer. Lo
+//!          usan los mdulos que agregan un campo propio a cada registro,
+//!          como la marca de tiempo.
+//!
+//! \param Id Nmero de particin.
+//! \param *Prefix Prefijo, de hasta \b M24LC512_RECORD_PREFIX_MAX bytes.
+//! \param PrefixSize Tamao del prefijo.
+//! \param *Record Datos del registro.
+//! \param Length Tamao de los datos.
+//! \param *Address Si no es 0 devuelve la direccin del encabezado del
+//!        registro, para usarla con \a M24LC512_recordSeek().
+//!
+//! \return \c true si se escribi y verific el registro.
+//*****************************************************************************
+bool M24LC512_recordAppendPrefixed(const uint8_t Id, const uint8_t *Prefix,
+                                   const uint8_t PrefixSize,
+                                   const uint8_t *Record, const uint8_t Length,
+                                   uint16_t *Address);
+
+//*****************************************************************************
+//! \brief Prepara la lectura de los registros de una particin.
+//!
+//! \details \b Descripcin \n
+//!          Coloca el iterador en el registro ms viejo de la particin.
+//!
+//! \param Id Nmero de particin.
+//! \param *Iterator Iterador a inicializar.
+//!
+//! \return \c true si la particin est configurada.
+//*****************************************************************************
+bool M24LC512_recordBegin(const uint8_t Id, M24LC512_RecordIterator *Iterator);
+
+//*****************************************************************************
+//! \brief Prepara la lectura a partir de un registro conocido.
+//!
+//! \details \b Descripcin \n
+//!          Coloca el iterador en el registro con nmero de secuencia
+//!          \b Sequence ubicado en \b Address, por ejemplo tomados de un
+//!          ndice. Si el registro ya no est en la particin devuelve
+//!          \c false.
+//!
+//! \param Id Nmero de particin.
+//! \param *Iterator Iterador a inicializar.
+//! \param Address Direccin del encabezado del registro.
+//! \param Sequence Nmero de secuencia del registro.
+//!
+//! \return \c true si el registro todava est guardado.
+//*****************************************************************************
+bool M24LC512_recordSeek(const uint8_t Id, M24LC512_RecordIterator *Iterator,
+                         const uint16_t Address, const uint16_t Sequence);
+
+//*****************************************************************************
+//! \brief Lee el prximo registro.
+//!
+//! \details \b Descripcin \n
+//!          Lee el registro apuntado por el iterador y lo avanza. Los
+//!          registros cuyo byte de verificacin no coincide se saltean y se
+//!          cuentan en \b errors. No modifica la cabecera.
+//!
+//! \param *Iterator Iterador inicializado con \a M24LC512_recordBegin().
+//! \param *Data Buffer de al menos \b M24LC512_RECORD_MAX bytes.
+//! \param *Length Devuelve el tamao del registro ledo.
+//!
+//! \return \c false si no quedan registros.
+//*****************************************************************************
+bool M24LC512_recordNext(M24LC512_RecordIterator *Iterator, uint8_t *Data,
+                         uint8_t *Length);
+
+//*****************************************************************************
+//! \brief Lee un registro de longitud conocida en una sola transaccin.
+//!
+//! \details \b Descripcin \n
+//!          Para quien ya guard la direccin, el nmero de secuencia y la
+//!          longitud de un registro (por ejemplo un ndice en la FRAM). Lee
+//!          el encabezado y los datos juntos y verifica que el registro siga
+//!          en la memoria, que sea el esperado y su byte de verificacin.
+//!
+//! \param Id Nmero de particin.
+//! \param Address Direccin del encabezado del registro.
+//! \param Sequence Nmero de secuencia del registro.
+//! \param *Data Buffer de \b M24LC512_RECORD_FRAME_SIZE + \b Length bytes,
+//!        devuelve los datos al comienzo.
+//! \param Length Tamao del registro (prefijo incluido).
+//!
+//! \return \c true si el registro es vlido.
+//*****************************************************************************
+bool M24LC512_recordFetch(const uint8_t Id, const uint16_t Address,
+                          const uint16_t Sequence, uint8_t *Data,
+                          const uint8_t Length);
+
+//*****************************************************************************
+//! \brief Descarta los registros ms viejos.
+//!
+//! \details \b Descripcin \n
+//!          Avanza la direccin del registro ms viejo \b Count registros,
+//!          leyendo solo sus encabezados, por ejemplo luego de enviarlos.
+//!
+//! \param Id Nmero de particin.
+//! \param Count Cantidad de registros a descartar.
+//!
+//! \return Cantidad de registros descartados.
+//*****************************************************************************
+uint16_t M24LC512_recordTrim(const uint8_t Id, const uint16_t Count);
+
+//*****************************************************************************
+//! \brief Descarta los registros de la pgina ms vieja.
+//!
+//! \details \b Descripcin \n
+//!          Igual que la vuelta del registro circular al llegar a esa pgina,
+//!          pero a pedido: el ms viejo pasa a ser el primer registro de la
+//!          pgina siguiente. Solo lee un encabezado.
+//!
+//! \param Id Nmero de particin.
+//!
+//! \return Cantidad de registros descartados.
+//*****************************************************************************
+uint16_t M24LC512_recordTrimPage(const uint8_t Id);
+
+//*****************************************************************************
+//! \brief Devuelve la cantidad de registros guardados en una particin.
+//!
+//! \param Id Nmero de particin.
+//!
+//! \return Cantidad de registros.
+//*****************************************************************************
+uint16_t M24LC512_recordCount(const uint8_t Id);
+
+//*****************************************************************************
+//! \brief Indica si el prximo registro comenzar una pgina.
+//!
+//! \details \b Descripcin \n
+//!          Permite a un codificador saber antes de escribir si el registro
+//!          ser el primero de su pgina, para que cada pgina se pueda
+//!          decodificar sola.
+//!
+//! \param Id Nmero de particin.
+//! \param Length Tamao del registro (prefijo incluido).
+//!
+//! \return \c true si el registro se escribir al comienzo de una pgina.
+//*****************************************************************************
+bool M24LC512_recordStartsPage(const uint8_t Id, const uint8_t Length);
+
+#endif /* RECORD_H_ */
@@ -0,0 +1,159 @@
+/*
+ * rollup.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// rollup.c - Promedios de las muestras por perodo en particiones propias.
+//
+//*****************************************************************************
+
+#include "rollup.h"
+#include "workbuf.h"
+
+// Los acumuladores se guardan en la FRAM principal para no perder el periodo en curso con un reset.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(rollupTier)
+static M24LC512_RollupTier rollupTier[M24LC512_ROLLUP_TIERS] = {0};
+#elif defined(__GNUC__)
+static M24LC512_RollupTier rollupTier[M24LC512_ROLLUP_TIERS] __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+//**********************************************************************************************************************************************************
+static bool M24LC512_rollupEmit(M24LC512_RollupTier *Tier, const uint8_t Channels)
+{
+    uint8_t stamp[M24LC512_TIME_SIZE];
+    int16_t average;
+    uint8_t i;
+
+    // Mismo formato que M24LC512_timeAppend(): marca de tiempo seguida de un valor de 16 bits por canal.
+    stamp[0] = (uint8_t)(Tier->start >> 24);
+    stamp[1] = (uint8_t)(Tier->start >> 16);
+    stamp[2] = (uint8_t)(Tier->start >> 8);
+    stamp[3] = (uint8_t)Tier->start;
+
+    for(i = 0 ; i < Channels ; i++)
+    {
+        average = (int16_t)(Tier->sum[i] / Tier->count);
+        M24LC512_workBuffer[2 * i] = (uint8_t)((uint16_t)average >> 8);
+        M24LC512_workBuffer[(2 * i) + 1] = (uint8_t)average;
+    }
+
+    return M24LC512_recordAppendPrefixed(Tier->partition, stamp, M24LC512_TIME_SIZE, M24LC512_workBuffer, 2 * Channels, 0);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_rollupInit(const uint8_t Tier, const uint8_t Id, const uint32_t Period)
+{
+    uint8_t state;
+
+    if((Tier >= M24LC512_ROLLUP_TIERS) || ((Period != 0) && (M24LC512_getPartition(Id) == 0)))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    rollupTier[Tier].partition = Id;
+    rollupTier[Tier].enabled = (Period != 0);
+    rollupTier[Tier].period = Period;
+    rollupTier[Tier].count = 0;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_rollupAdd(const uint32_t Timestamp, const int16_t *Value, const uint8_t Channels)
+{
+    M24LC512_RollupTier *tier;
+    bool ok = true;
+    uint32_t start;
+    uint8_t state;
+    uint8_t i;
+    uint8_t j;
+
+    // Los promedios se acumulan a medida que llegan las muestras, asi no hace falta releer las paginas de la EEPROM.
+    for(i = 0 ; i < M24LC512_ROLLUP_TIERS ; i++)
+    {
+        tier = &rollupTier[i];
+        if(!tier->enabled)
+        {
+            continue;
+        }
+
+        start = Timestamp - (Timestamp % tier->period);
+
+        if((tier->count != 0) && (start != tier->start))
+        {
+            // El periodo ya termino: aunque falle la escritura el acumulador se reinicia igual.
+            if(!M24LC512_rollupEmit(tier, Channels))
+            {
+                ok = false;
+            }
+        }
+
+        state = M24LC512_framUnlock();
+
+        if((tier->count == 0) || (start != tier->start))
+        {
+            tier->start = start;
+            tier->count = 0;
+            for(j = 0 ; j < M24LC512_SAMPLE_CHANNELS ; j++)
+            {
+                tier->sum[j] = 0;
+            }
+        }
+
+        for(j = 0 ; j < Channels ; j++)
+        {
+            tier->sum[j] += Value[j];
+        }
+        tier->count++;
+
+        M24LC512_framRestore(state);
+    }
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_rollupQueryBegin(const uint8_t Tier, const uint32_t From, const uint32_t To, M24LC512_TimeQuery *Query)
+{
+    if((Tier >= M24LC512_ROLLUP_TIERS) || !rollupTier[Tier].enabled)
+    {
+        return false;
+    }
+
+    Query->from = From;
+    Query->to = To;
+
+    // Los niveles tienen pocos registros: se recorren desde el mas viejo sin indice.
+    return M24LC512_recordBegin(rollupTier[Tier].partition, &Query->iterator);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_rollupNext(M24LC512_TimeQuery *Query, uint32_t *Timestamp, int16_t *Value, uint8_t *Channels)
+{
+    uint8_t length;
+    uint8_t i;
+
+    if(!M24LC512_timeQueryNext(Query, Timestamp, M24LC512_workBuffer, &length))
+    {
+        return false;
+    }
+
+    *Channels = length / 2;
+    if(*Channels > M24LC512_SAMPLE_CHANNELS)
+    {
+        *Channels = M24LC512_SAMPLE_CHANNELS;
+    }
+
+    for(i = 0 ; i < *Channels ; i++)
+    {
+        Value[i] = (int16_t)(((uint16_t)M24LC512_workBuffer[2 * i] << 8) | M24LC512_workBuffer[(2 * i) + 1]);
+    }
+
+    return true;
+}
@@ -0,0 +1,119 @@
+/**
+  * @file     rollup.h
+  * @brief    Promedios de las muestras por perodo en particiones propias.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// rollup.h - Promedios de las muestras por perodo en particiones propias.
+//
+//*****************************************************************************
+
+#ifndef ROLLUP_H_
+#define ROLLUP_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "sample.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Cantidad de niveles de promedios, por ejemplo 1 minuto y 1 hora.
+//*****************************************************************************
+#define M24LC512_ROLLUP_TIERS       2
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Nivel de promedios y acumulador del perodo en curso.
+//*****************************************************************************
+typedef struct
+{
+    uint8_t partition;      //!< Particin donde se guardan los promedios.
+    uint8_t enabled;        //!< Distinto de cero si el nivel est configurado.
+    uint32_t count;         //!< Muestras acumuladas en el perodo en curso.
+    uint32_t period;        //!< Duracin del perodo, en unidades de la marca de tiempo.
+    uint32_t start;         //!< Comienzo del perodo en curso.
+    int64_t sum[M24LC512_SAMPLE_CHANNELS];  //!< Suma de cada canal, no desborda con 2^32 muestras.
+} M24LC512_RollupTier;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura un nivel de promedios.
+//!
+//! \details \b Descripcin \n
+//!          Cada muestra guardada con \a M24LC512_sampleAppend() se acumula
+//!          y al terminar cada perodo de \b Period se escribe en la
+//!          particin \b Id un registro con la marca de tiempo del comienzo
+//!          del perodo y el promedio de cada canal. As la historia larga
+//!          sobrevive a la vuelta de la particin de las muestras.
+//!
+//! \param Tier Nmero de nivel, menor a \b M24LC512_ROLLUP_TIERS.
+//! \param Id Particin de los promedios, distinta de la de las muestras.
+//! \param Period Duracin del perodo, cero deshabilita el nivel.
+//!
+//! \return \c true si los parmetros son vlidos.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_rollupInit(const uint8_t Tier, const uint8_t Id,
+                         const uint32_t Period);
+
+//*****************************************************************************
+//! \brief Acumula una muestra en todos los niveles.
+//!
+//! \details \b Descripcin \n
+//!          La llama \a M24LC512_sampleAppend(). Si la muestra pertenece a
+//!          un perodo nuevo primero escribe el promedio del anterior. Si
+//!          esa escritura falla el promedio se pierde, pero la muestra se
+//!          acumula igual en el perodo nuevo.
+//!
+//! \param Timestamp Marca de tiempo de la muestra.
+//! \param *Value Valor de cada canal.
+//! \param Channels Cantidad de canales.
+//!
+//! \return \c false si no se pudo escribir el promedio de algn nivel.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_rollupAdd(const uint32_t Timestamp, const int16_t *Value,
+                        const uint8_t Channels);
+
+//*****************************************************************************
+//! \brief Prepara la lectura de los promedios de un nivel en un rango.
+//!
+//! \param Tier Nmero de nivel.
+//! \param From Comienzo del rango.
+//! \param To Fin del rango, inclusive.
+//! \param *Query Consulta a inicializar.
+//!
+//! \return \c true si el nivel est configurado.
+//*****************************************************************************
+bool M24LC512_rollupQueryBegin(const uint8_t Tier, const uint32_t From,
+                               const uint32_t To, M24LC512_TimeQuery *Query);
+
+//*****************************************************************************
+//! \brief Lee el prximo promedio del rango consultado.
+//!
+//! \param *Query Consulta inicializada con \a M24LC512_rollupQueryBegin().
+//! \param *Timestamp Devuelve el comienzo del perodo.
+//! \param *Value Devuelve el promedio de cada canal, con lugar para
+//!        \b M24LC512_SAMPLE_CHANNELS valores.
+//! \param *Channels Devuelve la cantidad de canales ledos.
+//!
+//! \return \c false al terminar el rango.
+//*****************************************************************************
+bool M24LC512_rollupNext(M24LC512_TimeQuery *Query, uint32_t *Timestamp,
+                         int16_t *Value, uint8_t *Channels);
+
+#endif /* ROLLUP_H_ */
@@ -0,0 +1,654 @@
+/*
+ * sample.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// sample.c - Muestras de los canales y resmenes por bloque en la memoria
+//            24LC512.
+//
+//*****************************************************************************
+
+#include "sample.h"
+#include "rollup.h"
+#include "workbuf.h"
+
+typedef struct
+{
+    uint8_t partition;
+    uint8_t channels;
+    uint16_t first;                                 // Posicion del bloque mas viejo
+    uint16_t count;                                 // Cantidad de bloques
+    uint8_t codec;                                  // M24LC512_CODEC_xxx
+    uint8_t reserved;
+    uint8_t width[M24LC512_SAMPLE_CHANNELS];        // Esquema: bits por canal, 0 equivale a 16
+    M24LC512_Zone zone[M24LC512_ZONE_ENTRIES];
+} M24LC512_SampleState;
+
+// Los resumenes se guardan en la FRAM principal para que sobrevivan a un reset.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(sampleState)
+static M24LC512_SampleState sampleState = {0};
+#elif defined(__GNUC__)
+static M24LC512_SampleState sampleState __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+
+// Ultima muestra escrita, base de las diferencias. Queda en RAM: luego de un reset se empieza con un keyframe.
+static int16_t samplePrevious[M24LC512_SAMPLE_CHANNELS];
+static uint32_t sampleLastTime;
+static uint32_t sampleLastDelta;
+static bool sampleSynced = false;
+//**********************************************************************************************************************************************************
+static M24LC512_Zone *M24LC512_sampleZone(const uint16_t Position)
+{
+    return &sampleState.zone[(sampleState.first + Position) % M24LC512_ZONE_ENTRIES];
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_zoneIsValid(const M24LC512_Partition *Part, const M24LC512_Zone *Zone)
+{
+    return (uint16_t)(Zone->sequence - Part->oldestSequence) < (uint16_t)(Part->nextSequence - Part->oldestSequence);
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_aggregateAdd(M24LC512_Aggregate *Result, const int16_t Min, const int16_t Max, const int32_t Sum,
+                                  const uint16_t Count)
+{
+    if(Min < Result->min)
+    {
+        Result->min = Min;
+    }
+    if(Max > Result->max)
+    {
+        Result->max = Max;
+    }
+    Result->sum += Sum;
+    Result->count += Count;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_varintPut(uint8_t *Data, uint16_t Value)
+{
+    uint8_t size = 0;
+
+    // 7 bits por byte, el bit 7 indica que sigue otro byte.
+    while(Value >= 0x80)
+    {
+        Data[size++] = (uint8_t)(Value | 0x80);
+        Value >>= 7;
+    }
+    Data[size++] = (uint8_t)Value;
+
+    return size;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_varintGet(const uint8_t *Data, const uint8_t Size, uint16_t *Value)
+{
+    uint8_t i;
+
+    *Value = 0;
+
+    for(i = 0 ; (i < Size) && (i < M24LC512_VARINT_MAX) ; i++)
+    {
+        *Value |= (uint16_t)(Data[i] & 0x7F) << (7 * i);
+        if((Data[i] & 0x80) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    return 0;                                                       // Varint incompleto
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_sampleWidth(const uint8_t Channel)
+{
+    return (sampleState.width[Channel] == 0) ? 16 : sampleState.width[Channel];
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_sampleFits(const int16_t *Value)
+{
+    int16_t limit;
+    uint8_t width;
+    uint8_t i;
+
+    // Cada canal se guarda con signo en su ancho: entra de -2^(ancho-1) a 2^(ancho-1)-1.
+    for(i = 0 ; i < sampleState.channels ; i++)
+    {
+        width = M24LC512_sampleWidth(i);
+        if(width < 16)
+        {
+            limit = (int16_t)(1 << (width - 1));
+            if((Value[i] < -limit) || (Value[i] >= limit))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_packValues(uint8_t *Data, const int16_t *Value)
+{
+    uint32_t bits = 0;
+    uint8_t count = 0;
+    uint8_t size = 0;
+    uint8_t width;
+    uint8_t i;
+
+    // Los canales se escriben uno detras de otro, del bit mas significativo al menos, cruzando los limites de los bytes.
+    for(i = 0 ; i < sampleState.channels ; i++)
+    {
+        width = M24LC512_sampleWidth(i);
+        bits = (bits << width) | ((uint16_t)Value[i] & (uint16_t)(0xFFFF >> (16 - width)));
+        count += width;
+
+        while(count >= 8)
+        {
+            count -= 8;
+            Data[size++] = (uint8_t)(bits >> count);
+        }
+    }
+
+    if(count > 0)
+    {
+        Data[size++] = (uint8_t)(bits << (8 - count));          // Bits que sobran del ultimo byte en cero
+    }
+
+    return size;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_unpackValues(const uint8_t *Data, const uint8_t Size, int16_t *Value)
+{
+    uint32_t bits = 0;
+    uint16_t raw;
+    uint8_t count = 0;
+    uint8_t size = 0;
+    uint8_t width;
+    uint8_t i;
+
+    for(i = 0 ; i < sampleState.channels ; i++)
+    {
+        width = M24LC512_sampleWidth(i);
+
+        while(count < width)
+        {
+            if(size >= Size)
+            {
+                return 0;
+            }
+            bits = (bits << 8) | Data[size++];
+            count += 8;
+        }
+
+        count -= width;
+        raw = (uint16_t)(bits >> count) & (uint16_t)(0xFFFF >> (16 - width));
+        if(raw & (uint16_t)(1U << (width - 1)))
+        {
+            raw |= (uint16_t)~(0xFFFF >> (16 - width));             // Extension de signo del campo
+        }
+        Value[i] = (int16_t)raw;
+    }
+
+    return size;
+}
+//**********************************************************************************************************************************************************
+static uint8_t M24LC512_sampleEncode(const uint32_t Timestamp, const int16_t *Value, const bool Keyframe)
+{
+    uint32_t dod;
+    uint16_t delta;
+    uint8_t size = 1;
+    uint8_t i;
+
+    M24LC512_workBuffer[0] = (sampleState.codec & M24LC512_CODEC_DELTA) ? M24LC512_SAMPLE_DELTA : 0;
+
+    // Marca de tiempo: diferencia de la diferencia con la muestra anterior. Si es cero alcanza con el bit de "a horario".
+    dod = (Timestamp - sampleLastTime) - sampleLastDelta;
+    dod = (dod << 1) ^ (0 - (dod >> 31));
+
+    if(Keyframe || !(sampleState.codec & M24LC512_CODEC_TIME) || (dod > 0xFFFF))
+    {
+        M24LC512_workBuffer[0] |= M24LC512_SAMPLE_TIME_FULL;
+        M24LC512_workBuffer[size++] = (uint8_t)(Timestamp >> 24);
+        M24LC512_workBuffer[size++] = (uint8_t)(Timestamp >> 16);
+        M24LC512_workBuffer[size++] = (uint8_t)(Timestamp >> 8);
+        M24LC512_workBuffer[size++] = (uint8_t)Timestamp;
+    }
+    else if(dod == 0)
+    {
+        M24LC512_workBuffer[0] |= M24LC512_SAMPLE_TIME_SCHEDULE;
+    }
+    else
+    {
+        M24LC512_workBuffer[0] |= M24LC512_SAMPLE_TIME_DOD;
+        size += M24LC512_varintPut(&M24LC512_workBuffer[size], (uint16_t)dod);
+    }
+
+    if(Keyframe || !(sampleState.codec & M24LC512_CODEC_DELTA))
+    {
+        M24LC512_workBuffer[0] |= Keyframe ? M24LC512_SAMPLE_KEYFRAME : 0;
+
+        if(sampleState.codec & M24LC512_CODEC_PACKED)
+        {
+            M24LC512_workBuffer[0] |= M24LC512_SAMPLE_PACKED;
+            size += M24LC512_packValues(&M24LC512_workBuffer[size], Value);
+        }
+        else
+        {
+            for(i = 0 ; i < sampleState.channels ; i++)
+            {
+                M24LC512_workBuffer[size++] = (uint8_t)((uint16_t)Value[i] >> 8);
+                M24LC512_workBuffer[size++] = (uint8_t)Value[i];
+            }
+        }
+    }
+    else
+    {
+        for(i = 0 ; i < sampleState.channels ; i++)
+        {
+            // Diferencia modulo 2^16 mapeada con zigzag: los valores chicos, positivos o negativos, quedan chicos.
+            delta = (uint16_t)Value[i] - (uint16_t)samplePrevious[i];
+            delta = (uint16_t)(delta << 1) ^ (uint16_t)(0 - (delta >> 15));
+            size += M24LC512_varintPut(&M24LC512_workBuffer[size], delta);
+        }
+    }
+
+    return size;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_sampleDecode(M24LC512_SampleQuery *Query, const uint8_t *Data, const uint8_t Size,
+                                  uint32_t *Timestamp, int16_t *Value)
+{
+    const bool keyframe = (Size != 0) && (Data[0] & M24LC512_SAMPLE_KEYFRAME);
+    uint32_t timestamp;
+    uint16_t delta;
+    uint8_t used;
+    uint8_t offset = 1;
+    uint8_t i;
+
+    if((Size == 0) || (!keyframe && !Query->synced))
+    {
+        return false;                                               // Diferencia sin la muestra anterior
+    }
+
+    switch(Data[0] & M24LC512_SAMPLE_TIME_MASK)
+    {
+        case M24LC512_SAMPLE_TIME_FULL:
+            if(Size < (offset + M24LC512_TIME_SIZE))
+            {
+                return false;
+            }
+            timestamp = ((uint32_t)Data[1] << 24) | ((uint32_t)Data[2] << 16) | ((uint32_t)Data[3] << 8) | Data[4];
+            offset += M24LC512_TIME_SIZE;
+            break;
+
+        case M24LC512_SAMPLE_TIME_SCHEDULE:
+            timestamp = Query->lastTime + Query->lastDelta;
+            break;
+
+        case M24LC512_SAMPLE_TIME_DOD:
+            used = M24LC512_varintGet(&Data[offset], Size - offset, &delta);
+            if(used == 0)
+            {
+                Query->synced = false;
+                return false;
+            }
+            offset += used;
+            timestamp = Query->lastTime + Query->lastDelta + (uint32_t)((delta >> 1) ^ (0 - (uint32_t)(delta & 1)));
+            break;
+
+        default:
+            return false;
+    }
+
+    if(Data[0] & M24LC512_SAMPLE_PACKED)
+    {
+        used = M24LC512_unpackValues(&Data[offset], Size - offset, Value);
+        if(used == 0)
+        {
+            return false;
+        }
+    }
+    else if(keyframe || !(Data[0] & M24LC512_SAMPLE_DELTA))
+    {
+        if(Size < (offset + (2 * sampleState.channels)))
+        {
+            return false;
+        }
+
+        for(i = 0 ; i < sampleState.channels ; i++)
+        {
+            Value[i] = (int16_t)(((uint16_t)Data[offset] << 8) | Data[offset + 1]);
+            offset += 2;
+        }
+    }
+    else
+    {
+        for(i = 0 ; i < sampleState.channels ; i++)
+        {
+            used = M24LC512_varintGet(&Data[offset], Size - offset, &delta);
+            if(used == 0)
+            {
+                Query->synced = false;
+                return false;
+            }
+            offset += used;
+
+            delta = (delta >> 1) ^ (uint16_t)(0 - (delta & 1));
+            Value[i] = (int16_t)((uint16_t)Query->previous[i] + delta);
+        }
+    }
+
+    for(i = 0 ; i < sampleState.channels ; i++)
+    {
+        Query->previous[i] = Value[i];
+    }
+    Query->lastDelta = keyframe ? 0 : (timestamp - Query->lastTime);   // La marca de tiempo recomienza en cada keyframe
+    Query->lastTime = timestamp;
+    Query->synced = true;
+    *Timestamp = timestamp;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleInit(const uint8_t Id, const uint8_t Channels)
+{
+    uint8_t state;
+
+    if((Channels == 0) || (Channels > M24LC512_SAMPLE_CHANNELS) || (M24LC512_getPartition(Id) == 0))
+    {
+        return false;
+    }
+
+    M24LC512_timeIndexInit(Id);
+
+    state = M24LC512_framUnlock();
+
+    sampleState.partition = Id;
+    sampleState.channels = Channels;
+    sampleState.first = 0;
+    sampleState.count = 0;
+
+    M24LC512_framRestore(state);
+
+    sampleSynced = false;
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleSetCodec(const uint8_t Codec)
+{
+    uint8_t state;
+
+    if(Codec > (M24LC512_CODEC_DELTA | M24LC512_CODEC_TIME | M24LC512_CODEC_PACKED))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+    sampleState.codec = Codec;
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleSetSchema(const uint8_t *Width)
+{
+    uint8_t state;
+    uint8_t i;
+
+    for(i = 0 ; i < M24LC512_SAMPLE_CHANNELS ; i++)
+    {
+        if((Width[i] == 0) || (Width[i] > 16))
+        {
+            return false;
+        }
+    }
+
+    state = M24LC512_framUnlock();
+    for(i = 0 ; i < M24LC512_SAMPLE_CHANNELS ; i++)
+    {
+        sampleState.width[i] = Width[i];
+    }
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleAppend(const uint32_t Timestamp, const int16_t *Value)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(sampleState.partition);
+    M24LC512_Zone *zone;
+    M24LC512_ChannelSummary *summary;
+    uint16_t address;
+    uint16_t offset;
+    bool boundary;
+    bool keyframe;
+    uint8_t size;
+    uint8_t state;
+    uint8_t i;
+
+    if((part == 0) || (sampleState.channels == 0))
+    {
+        return false;
+    }
+
+    // Un valor que no entra en el esquema se rechaza antes de llegar a la diferencia, los resumenes y los promedios.
+    if((sampleState.codec & M24LC512_CODEC_PACKED) && !M24LC512_sampleFits(Value))
+    {
+        return false;
+    }
+
+    // Un bloque nuevo tambien comienza con un keyframe, asi se puede leer desde su primera muestra.
+    keyframe = (sampleState.codec == M24LC512_CODEC_RAW) || !sampleSynced || (sampleState.count == 0) ||
+               !M24LC512_zoneIsValid(part, M24LC512_sampleZone(sampleState.count - 1));
+
+    if(!keyframe)
+    {
+        size = M24LC512_sampleEncode(Timestamp, Value, false);
+        keyframe = M24LC512_recordStartsPage(sampleState.partition, size);
+    }
+
+    if(keyframe)
+    {
+        size = M24LC512_sampleEncode(Timestamp, Value, true);
+    }
+
+    // La marca de tiempo va codificada dentro de la muestra, el indice se actualiza aparte.
+    if(!M24LC512_recordAppendPrefixed(sampleState.partition, 0, 0, M24LC512_workBuffer, size, &address))
+    {
+        return false;
+    }
+
+    M24LC512_timeIndexAdd(Timestamp, address);
+
+    for(i = 0 ; i < sampleState.channels ; i++)
+    {
+        samplePrevious[i] = Value[i];
+    }
+    sampleLastDelta = keyframe ? 0 : (Timestamp - sampleLastTime);
+    sampleLastTime = Timestamp;
+    sampleSynced = true;
+
+    // Se abre un bloque nuevo con el primer registro de una de cada M24LC512_ZONE_PAGES paginas.
+    offset = address % M24LC512_MAXPAGEWRITE;
+    boundary = (offset == M24LC512_stampSize(address - offset)) &&
+               ((((address / M24LC512_MAXPAGEWRITE) - part->startPage) % M24LC512_ZONE_PAGES) == 0);
+
+    state = M24LC512_framUnlock();
+
+    if((sampleState.count == 0) || boundary ||
+       !M24LC512_zoneIsValid(part, M24LC512_sampleZone(sampleState.count - 1)))
+    {
+        if(sampleState.count == M24LC512_ZONE_ENTRIES)
+        {
+            sampleState.first = (sampleState.first + 1) % M24LC512_ZONE_ENTRIES;
+            sampleState.count--;
+        }
+
+        zone = M24LC512_sampleZone(sampleState.count);
+        zone->first = Timestamp;
+        zone->address = address;
+        zone->sequence = part->nextSequence - 1;
+        zone->count = 0;
+
+        for(i = 0 ; i < sampleState.channels ; i++)
+        {
+            zone->channel[i].min = Value[i];
+            zone->channel[i].max = Value[i];
+            zone->channel[i].sum = 0;
+        }
+
+        sampleState.count++;
+    }
+
+    zone = M24LC512_sampleZone(sampleState.count - 1);
+    zone->last = Timestamp;
+    zone->count++;
+
+    for(i = 0 ; i < sampleState.channels ; i++)
+    {
+        summary = &zone->channel[i];
+        if(Value[i] < summary->min)
+        {
+            summary->min = Value[i];
+        }
+        if(Value[i] > summary->max)
+        {
+            summary->max = Value[i];
+        }
+        summary->sum += Value[i];
+    }
+
+    M24LC512_framRestore(state);
+
+    // La muestra ya quedo guardada; si falla un promedio se informa igual.
+    return M24LC512_rollupAdd(Timestamp, Value, sampleState.channels);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleAggregate(const uint8_t Channel, const uint32_t From, const uint32_t To, M24LC512_Aggregate *Result)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(sampleState.partition);
+    const M24LC512_Zone *zone;
+    M24LC512_SampleQuery query;
+    uint32_t timestamp;
+    uint16_t end;
+    uint16_t count;
+    uint16_t i;
+    bool started;
+    int16_t value[M24LC512_SAMPLE_CHANNELS];
+
+    if((part == 0) || (Channel >= sampleState.channels))
+    {
+        return false;
+    }
+
+    Result->min = INT16_MAX;
+    Result->max = INT16_MIN;
+    Result->sum = 0;
+    Result->count = 0;
+
+    for(i = 0 ; i < sampleState.count ; i++)
+    {
+        zone = M24LC512_sampleZone(i);
+        end = ((i + 1) < sampleState.count) ? M24LC512_sampleZone(i + 1)->sequence : part->nextSequence;
+
+        if((zone->count == 0) || (zone->last < From) || (zone->first > To))
+        {
+            continue;
+        }
+
+        if(M24LC512_zoneIsValid(part, zone) && (From <= zone->first) && (zone->last <= To))
+        {
+            // Bloque contenido en el rango: se responde solo con la FRAM.
+            M24LC512_aggregateAdd(Result, zone->channel[Channel].min, zone->channel[Channel].max,
+                                  zone->channel[Channel].sum, zone->count);
+            continue;
+        }
+
+        // Bloque de un extremo del rango, o con sus primeras paginas ya sobrescritas: se leen sus muestras.
+        query.synced = false;
+        query.from = From;
+        query.to = To;
+
+        if(M24LC512_zoneIsValid(part, zone))
+        {
+            count = end - zone->sequence;
+            started = M24LC512_recordSeek(sampleState.partition, &query.iterator, zone->address, zone->sequence);
+        }
+        else
+        {
+            count = end - part->oldestSequence;
+            started = (count <= (uint16_t)(part->nextSequence - part->oldestSequence)) &&
+                      M24LC512_recordBegin(sampleState.partition, &query.iterator);
+        }
+
+        if(!started)
+        {
+            continue;
+        }
+
+        if(query.iterator.remaining > count)
+        {
+            query.iterator.remaining = count;
+        }
+
+        while(M24LC512_sampleNext(&query, &timestamp, value))
+        {
+            M24LC512_aggregateAdd(Result, value[Channel], value[Channel], value[Channel], 1);
+        }
+    }
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleQueryBegin(const uint32_t From, const uint32_t To, M24LC512_SampleQuery *Query)
+{
+    Query->from = From;
+    Query->to = To;
+    Query->synced = false;
+
+    // El indice apunta siempre al primer registro de una pagina, que es un keyframe.
+    return M24LC512_timeIndexSeek(From, &Query->iterator);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_sampleNext(M24LC512_SampleQuery *Query, uint32_t *Timestamp, int16_t *Value)
+{
+    uint32_t timestamp;
+    uint16_t errors;
+    uint8_t length;
+
+    for(;;)
+    {
+        errors = Query->iterator.errors;
+        if(!M24LC512_recordNext(&Query->iterator, M24LC512_workBuffer, &length))
+        {
+            return false;
+        }
+
+        if(Query->iterator.errors != errors)
+        {
+            Query->synced = false;                                  // Se salteo una muestra: las diferencias ya no sirven
+        }
+
+        // Se decodifican tambien las muestras anteriores al rango para mantener la base de las diferencias.
+        if(!M24LC512_sampleDecode(Query, M24LC512_workBuffer, length, &timestamp, Value))
+        {
+            continue;
+        }
+
+        if(timestamp > Query->to)
+        {
+            Query->iterator.remaining = 0;
+            return false;
+        }
+
+        if(timestamp >= Query->from)
+        {
+            *Timestamp = timestamp;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,268 @@
+/**
+  * @file     sample.h
+  * @brief    Muestras de los canales y resmenes por bloque en la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// sample.h - Muestras de los canales y resmenes por bloque en la memoria
+//            24LC512.
+//
+//*****************************************************************************
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "timeindex.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Cantidad mxima de canales por muestra.
+//*****************************************************************************
+#define M24LC512_SAMPLE_CHANNELS    4
+
+//*****************************************************************************
+//! \details Cantidad de bloques resumidos en la FRAM.
+//*****************************************************************************
+#define M24LC512_ZONE_ENTRIES       32
+
+//*****************************************************************************
+//! \details Pginas de la particin que cubre cada bloque. Con 32 bloques de
+//!          16 pginas se cubre la memoria completa.
+//*****************************************************************************
+#define M24LC512_ZONE_PAGES         16
+
+//*****************************************************************************
+//! \details Codificacin de los valores de las muestras.
+//*****************************************************************************
+//! @name Cdecs
+//! @{
+#define M24LC512_CODEC_RAW          0x00    //!< 16 bits por canal y marca de tiempo completa.
+#define M24LC512_CODEC_DELTA        0x01    //!< Diferencia con la muestra anterior, zigzag y varint.
+#define M24LC512_CODEC_TIME         0x02    //!< Marca de tiempo como diferencia de la diferencia.
+#define M24LC512_CODEC_PACKED       0x04    //!< Valores completos con los bits del esquema.
+//! @}
+
+//*****************************************************************************
+//! \details Primer byte de los datos de cada muestra. Un keyframe guarda los
+//!          valores completos y no depende de las muestras anteriores; hay
+//!          uno al comienzo de cada pgina para que se decodifique sola.
+//*****************************************************************************
+//! @name Formato de la muestra
+//! @{
+#define M24LC512_SAMPLE_KEYFRAME        0x01
+#define M24LC512_SAMPLE_DELTA           0x02    //!< Valores como diferencias.
+#define M24LC512_SAMPLE_TIME_MASK       0x0C
+#define M24LC512_SAMPLE_TIME_FULL       0x00    //!< Marca de tiempo de 32 bits.
+#define M24LC512_SAMPLE_TIME_SCHEDULE   0x04    //!< Misma diferencia que la anterior, no ocupa bytes.
+#define M24LC512_SAMPLE_TIME_DOD        0x08    //!< Diferencia de la diferencia con zigzag y varint.
+#define M24LC512_SAMPLE_PACKED          0x10    //!< Valores completos empaquetados con el esquema.
+//! @}
+
+//*****************************************************************************
+//! \details Tamao mximo de un valor codificado con varint (16 bits).
+//*****************************************************************************
+#define M24LC512_VARINT_MAX         3
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Resumen de un canal dentro de un bloque.
+//*****************************************************************************
+typedef struct
+{
+    int16_t min;            //!< Valor mnimo.
+    int16_t max;            //!< Valor mximo.
+    int32_t sum;            //!< Suma de los valores.
+} M24LC512_ChannelSummary;
+
+//*****************************************************************************
+//! \details Resumen de un bloque de pginas (zone map).
+//*****************************************************************************
+typedef struct
+{
+    uint32_t first;         //!< Marca de tiempo de la primera muestra.
+    uint32_t last;          //!< Marca de tiempo de la ltima muestra.
+    uint16_t address;       //!< Direccin del registro de la primera muestra.
+    uint16_t sequence;      //!< Nmero de secuencia de la primera muestra.
+    uint16_t count;         //!< Cantidad de muestras del bloque.
+    uint16_t reserved;
+    M24LC512_ChannelSummary channel[M24LC512_SAMPLE_CHANNELS];
+} M24LC512_Zone;
+
+//*****************************************************************************
+//! \details Resultado de una consulta de agregados.
+//*****************************************************************************
+typedef struct
+{
+    int16_t min;            //!< Valor mnimo.
+    int16_t max;            //!< Valor mximo.
+    int32_t sum;            //!< Suma de los valores, el promedio es sum / count.
+    uint32_t count;         //!< Cantidad de muestras.
+} M24LC512_Aggregate;
+
+//*****************************************************************************
+//! \details Estado de una lectura de muestras en un rango de tiempo.
+//*****************************************************************************
+typedef struct
+{
+    M24LC512_RecordIterator iterator;
+    uint32_t from;          //!< Comienzo del rango.
+    uint32_t to;            //!< Fin del rango, inclusive.
+    uint32_t lastTime;      //!< Marca de tiempo de la ltima muestra.
+    uint32_t lastDelta;     //!< Diferencia entre las dos ltimas marcas de tiempo.
+    int16_t previous[M24LC512_SAMPLE_CHANNELS];  //!< ltima muestra decodificada.
+    bool synced;            //!< \c true si \b previous es vlida.
+} M24LC512_SampleQuery;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura la particin y la cantidad de canales de las muestras.
+//!
+//! \details \b Descripcin \n
+//!          Borra los resmenes y el ndice de tiempo y los asocia a la
+//!          particin \b Id.
+//!
+//! \param Id Nmero de particin.
+//! \param Channels Cantidad de canales, hasta \b M24LC512_SAMPLE_CHANNELS.
+//!
+//! \return \c true si los parmetros son vlidos.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_sampleInit(const uint8_t Id, const uint8_t Channels);
+
+//*****************************************************************************
+//! \brief Selecciona la codificacin de las muestras siguientes.
+//!
+//! \details \b Descripcin \n
+//!          Con \b M24LC512_CODEC_DELTA cada canal se guarda como la
+//!          diferencia con la muestra anterior, mapeada con zigzag y
+//!          empaquetada con varint, por lo que una seal que cambia despacio
+//!          ocupa un byte por canal. Con \b M24LC512_CODEC_TIME la marca de
+//!          tiempo se guarda como la diferencia de la diferencia con la
+//!          anterior: si la muestra lleg a horario solo ocupa un bit del
+//!          byte de formato, si hubo una demora chica se guarda con varint y
+//!          si no, completa. Ambos se reinician en cada keyframe. Cada
+//!          muestra indica su formato, as que se puede cambiar en cualquier
+//!          momento.
+//!
+//!          Con \b M24LC512_CODEC_PACKED los valores completos (keyframes
+//!          y muestras sin diferencias) ocupan solo los bits indicados por
+//!          \a M24LC512_sampleSetSchema().
+//!
+//! \param Codec Combinacin de \b M24LC512_CODEC_DELTA,
+//!        \b M24LC512_CODEC_TIME y \b M24LC512_CODEC_PACKED, o
+//!        \b M24LC512_CODEC_RAW.
+//!
+//! \return \c true si el cdec es vlido.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_sampleSetCodec(const uint8_t Codec);
+
+//*****************************************************************************
+//! \brief Configura la cantidad de bits de cada canal.
+//!
+//! \details \b Descripcin \n
+//!          Esquema usado por \b M24LC512_CODEC_PACKED, por ejemplo 11 o 13
+//!          bits para los canales del ADC de 10 o 12 bits. Los valores se
+//!          guardan con signo, as que un canal de \b n bits admite de
+//!          -2^(n-1) a 2^(n-1)-1; \a M24LC512_sampleAppend() rechaza las
+//!          muestras que no entran. El esquema se usa tambin para leer,
+//!          por lo que no se debe cambiar mientras haya muestras
+//!          empaquetadas guardadas.
+//!
+//! \param *Width Bits de cada uno de los \b M24LC512_SAMPLE_CHANNELS
+//!        canales, de 1 a 16.
+//!
+//! \return \c true si el esquema es vlido.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_sampleSetSchema(const uint8_t *Width);
+
+//*****************************************************************************
+//! \brief Guarda una muestra de todos los canales.
+//!
+//! \details \b Descripcin \n
+//!          Escribe la muestra como un registro con marca de tiempo y
+//!          actualiza en la FRAM el resumen (mnimo, mximo, suma y
+//!          cantidad) del bloque actual. Se escribe un keyframe si la
+//!          muestra comienza una pgina o un bloque. Se abre un bloque nuevo cada
+//!          \b M24LC512_ZONE_PAGES pginas. Por ltimo acumula la muestra
+//!          en los niveles de promedios con \a M24LC512_rollupAdd().
+//!
+//! \param Timestamp Marca de tiempo, creciente.
+//! \param *Value Valor de cada canal configurado.
+//!
+//! \return \c true si se escribi la muestra y los promedios que
+//!         terminaron con ella, \c false tambin si con
+//!         \b M24LC512_CODEC_PACKED algn valor no entra en el esquema.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_sampleAppend(const uint32_t Timestamp, const int16_t *Value);
+
+//*****************************************************************************
+//! \brief Calcula mnimo, mximo, suma y cantidad de un canal en un rango.
+//!
+//! \details \b Descripcin \n
+//!          Los bloques contenidos por completo en el rango se responden con
+//!          los resmenes de la FRAM. Solo se leen de la EEPROM las muestras
+//!          de los bloques de los extremos que el rango cubre en parte.
+//!
+//! \param Channel Nmero de canal.
+//! \param From Comienzo del rango.
+//! \param To Fin del rango, inclusive.
+//! \param *Result Resultado, con \b count en cero si no hay muestras.
+//!
+//! \return \c true si el canal es vlido.
+//*****************************************************************************
+bool M24LC512_sampleAggregate(const uint8_t Channel, const uint32_t From,
+                              const uint32_t To, M24LC512_Aggregate *Result);
+
+//*****************************************************************************
+//! \brief Prepara la lectura de las muestras entre dos marcas de tiempo.
+//!
+//! \param From Comienzo del rango.
+//! \param To Fin del rango, inclusive.
+//! \param *Query Consulta a inicializar.
+//!
+//! \return \c true si la particin de las muestras est configurada.
+//*****************************************************************************
+bool M24LC512_sampleQueryBegin(const uint32_t From, const uint32_t To,
+                               M24LC512_SampleQuery *Query);
+
+//*****************************************************************************
+//! \brief Lee y decodifica la prxima muestra del rango consultado.
+//!
+//! \details \b Descripcin \n
+//!          Las muestras codificadas con diferencias necesitan la anterior:
+//!          si se perdi una muestra por fallar su verificacin, se saltean
+//!          las siguientes hasta el prximo keyframe.
+//!
+//! \param *Query Consulta inicializada con \a M24LC512_sampleQueryBegin().
+//! \param *Timestamp Devuelve la marca de tiempo de la muestra.
+//! \param *Value Devuelve el valor de cada canal configurado.
+//!
+//! \return \c false al terminar el rango.
+//*****************************************************************************
+bool M24LC512_sampleNext(M24LC512_SampleQuery *Query, uint32_t *Timestamp,
+                         int16_t *Value);
+
+#endif /* SAMPLE_H_ */
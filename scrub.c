@@ -0,0 +1,127 @@
+/*
+ * scrub.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// scrub.c - Repaso de la memoria 24LC512 en los tiempos libres.
+//
+//*****************************************************************************
+
+#include <string.h>
+
+#include "scrub.h"
+#include "workbuf.h"
+
+// El cursor y las estadisticas se guardan en la FRAM principal: el repaso sigue donde estaba despues de un reset.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(scrub)
+static M24LC512_Scrub scrub = {0};
+#elif defined(__GNUC__)
+static M24LC512_Scrub scrub __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+//**********************************************************************************************************************************************************
+static void M24LC512_scrubStart(const uint8_t Mode, const uint8_t Range, const uint16_t StartPage,
+                                const uint16_t PageCount)
+{
+    uint8_t state = M24LC512_framUnlock();
+
+    scrub.mode = M24LC512_SCRUB_NONE;                           // Se deshabilita mientras se cambia la configuracion
+    scrub.range = Range;
+    scrub.startPage = StartPage;
+    scrub.pageCount = PageCount;
+    scrub.cursor = 0;
+    memset(&scrub.stats, 0, sizeof(scrub.stats));
+    scrub.mode = (PageCount != 0) ? Mode : M24LC512_SCRUB_NONE;
+
+    M24LC512_framRestore(state);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_scrubCrc(const uint16_t StartPage, const uint16_t PageCount)
+{
+    // Las paginas de las particiones y de las zonas no llevan CRC16 al final.
+    if(M24LC512_pagesTaken(M24LC512_PARTITIONS, M24LC512_ZONES, StartPage, PageCount))
+    {
+        return false;
+    }
+
+    M24LC512_scrubStart(M24LC512_SCRUB_CRC, 0, StartPage, PageCount);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_scrubEcc(const uint8_t Range)
+{
+    uint16_t pageCount = M24LC512_eccCapacity(Range) / M24LC512_ECC_PAGE_DATA;
+
+    if(pageCount == 0)
+    {
+        return false;
+    }
+
+    M24LC512_scrubStart(M24LC512_SCRUB_ECC, Range, 0, pageCount);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_scrubStep(void)
+{
+    uint8_t result;
+    uint8_t state;
+
+    if((scrub.mode == M24LC512_SCRUB_NONE) || (scrub.cursor >= scrub.pageCount))
+    {
+        return M24LC512_SCRUB_IDLE;
+    }
+
+    if(scrub.mode == M24LC512_SCRUB_CRC)
+    {
+        // Una segunda lectura descarta un error del bus; si vuelve a fallar el error esta en la memoria.
+        result = (M24LC512_crcPageRead(scrub.startPage + scrub.cursor, M24LC512_workBuffer) ||
+                  M24LC512_crcPageRead(scrub.startPage + scrub.cursor, M24LC512_workBuffer)) ?
+                 M24LC512_SCRUB_OK : M24LC512_SCRUB_FAILED;
+    }
+    else
+    {
+        switch(M24LC512_eccScrubPage(scrub.range, scrub.cursor))
+        {
+            case M24LC512_ECC_OK:           result = M24LC512_SCRUB_OK;         break;
+            case M24LC512_ECC_CORRECTED:    result = M24LC512_SCRUB_REPAIRED;   break;
+            default:                        result = M24LC512_SCRUB_FAILED;     break;  // Tambien si fallo la reescritura
+        }
+    }
+
+    state = M24LC512_framUnlock();
+
+    scrub.stats.checked++;
+
+    if(result == M24LC512_SCRUB_REPAIRED)
+    {
+        scrub.stats.repaired++;
+    }
+    else if(result == M24LC512_SCRUB_FAILED)
+    {
+        scrub.stats.failed++;
+    }
+
+    scrub.cursor++;
+    if(scrub.cursor >= scrub.pageCount)
+    {
+        scrub.cursor = 0;
+        scrub.stats.passes++;
+    }
+
+    M24LC512_framRestore(state);
+
+    return result;
+}
+//**********************************************************************************************************************************************************
+void M24LC512_scrubStats(M24LC512_ScrubStats *Stats)
+{
+    *Stats = scrub.stats;
+}
@@ -0,0 +1,146 @@
+/**
+  * @file     scrub.h
+  * @brief    Repaso de la memoria 24LC512 en los tiempos libres.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// scrub.h - Repaso de la memoria 24LC512 en los tiempos libres.
+//
+//*****************************************************************************
+
+#ifndef SCRUB_H_
+#define SCRUB_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "ecc.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Qu protege a las pginas que se repasan.
+//*****************************************************************************
+//! @name Modos de repaso
+//! @{
+#define M24LC512_SCRUB_NONE         0   //!< Sin repaso configurado.
+#define M24LC512_SCRUB_CRC          1   //!< Pginas de \a M24LC512_crcPageWrite().
+#define M24LC512_SCRUB_ECC          2   //!< Una zona de \a M24LC512_eccInit().
+//! @}
+
+//*****************************************************************************
+//! \details Resultado de \a M24LC512_scrubStep().
+//*****************************************************************************
+//! @name Resultados del repaso
+//! @{
+#define M24LC512_SCRUB_IDLE         0   //!< No hay repaso configurado.
+#define M24LC512_SCRUB_OK           1   //!< La pgina est bien.
+#define M24LC512_SCRUB_REPAIRED     2   //!< Se corrigi y reescribi.
+#define M24LC512_SCRUB_FAILED       3   //!< Tiene errores que no se pueden corregir o no se pudo reescribir.
+//! @}
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Estadsticas del repaso.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t passes;        //!< Pasadas completas.
+    uint16_t checked;       //!< Pginas revisadas.
+    uint16_t repaired;      //!< Pginas reescritas corregidas.
+    uint16_t failed;        //!< Pginas con errores sin corregir.
+} M24LC512_ScrubStats;
+
+//*****************************************************************************
+//! \details Estado del repaso, guardado en la FRAM para seguir despus de un
+//!          reset.
+//*****************************************************************************
+typedef struct
+{
+    uint8_t mode;           //!< \b M24LC512_SCRUB_NONE, \b CRC o \b ECC.
+    uint8_t range;          //!< Zona de \a M24LC512_eccInit() en modo \b ECC.
+    uint16_t startPage;     //!< Primera pgina en modo \b CRC.
+    uint16_t pageCount;     //!< Pginas a repasar.
+    uint16_t cursor;        //!< Prxima pgina, relativa al comienzo.
+    M24LC512_ScrubStats stats;
+} M24LC512_Scrub;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura el repaso de pginas con CRC16.
+//!
+//! \details \b Descripcin \n
+//!          Todas las pginas se deben haber escrito con
+//!          \a M24LC512_crcPageWrite(). El CRC solo detecta errores: una
+//!          pgina que falla dos lecturas seguidas se cuenta en \b failed.
+//!          Las pginas no pueden ser de una particin ni de una zona
+//!          reservada, que no llevan CRC16 y se contaran todas en
+//!          \b failed. Comienza desde la primera pgina y pone en cero las
+//!          estadsticas.
+//!
+//! \param StartPage Primera pgina.
+//! \param PageCount Cantidad de pginas, cero para detener el repaso.
+//!
+//! \return \c true si las pginas estn antes de las de reserva y fuera de
+//!         las particiones y de las zonas reservadas.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_scrubCrc(const uint16_t StartPage, const uint16_t PageCount);
+
+//*****************************************************************************
+//! \brief Configura el repaso de una zona con correccin de errores.
+//!
+//! \details \b Descripcin \n
+//!          Las pginas con un bit cambiado en alguna palabra se reescriben
+//!          corregidas (ver \a M24LC512_eccScrubPage()). Comienza desde la
+//!          primera pgina y pone en cero las estadsticas.
+//!
+//! \param Range Zona configurada con \a M24LC512_eccInit().
+//!
+//! \return \c true si la zona est configurada.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_scrubEcc(const uint8_t Range);
+
+//*****************************************************************************
+//! \brief Repasa la pgina siguiente.
+//!
+//! \details \b Descripcin \n
+//!          Se llama desde el lazo principal cuando no hay muestras
+//!          pendientes, o desde el tick de un Timer_A. Cada llamada revisa una
+//!          sola pgina: con SCL a 400 kHz son unos 3 ms si est bien y unos
+//!          11 ms si se reescribe (un ciclo de escritura), por lo que nunca
+//!          demora ms que eso una muestra. El cursor avanza en la FRAM, as
+//!          un reset no hace volver a empezar.
+//!
+//! \return \b M24LC512_SCRUB_IDLE, \b M24LC512_SCRUB_OK,
+//!         \b M24LC512_SCRUB_REPAIRED o \b M24LC512_SCRUB_FAILED.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE, \b SYSCFG0,
+//!            \b CRCINIRES y \b CRCDI.
+//*****************************************************************************
+uint8_t M24LC512_scrubStep(void);
+
+//*****************************************************************************
+//! \brief Devuelve las estadsticas del repaso.
+//!
+//! \param *Stats Devuelve las estadsticas.
+//!
+//! \return \c void.
+//*****************************************************************************
+void M24LC512_scrubStats(M24LC512_ScrubStats *Stats);
+
+#endif /* SCRUB_H_ */
@@ -0,0 +1,203 @@
+/*
+ * timeindex.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// timeindex.c - ndice por marca de tiempo de los registros de la memoria
+//               24LC512.
+//
+//*****************************************************************************
+
+#include <string.h>
+#include "timeindex.h"
+
+// El indice se guarda en la FRAM principal para que sobreviva a un reset.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(timeIndex)
+static M24LC512_TimeIndex timeIndex = {0};
+#elif defined(__GNUC__)
+static M24LC512_TimeIndex timeIndex __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+//**********************************************************************************************************************************************************
+static const M24LC512_TimeEntry *M24LC512_timeEntry(const uint16_t Position)
+{
+    return &timeIndex.entry[(timeIndex.first + Position) % M24LC512_TIME_INDEX_ENTRIES];
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_timeEntryIsValid(const M24LC512_Partition *Part, const M24LC512_TimeEntry *Entry)
+{
+    // Las entradas de registros que ya se sobrescribieron o descartaron quedan fuera de la ventana de secuencias.
+    return (uint16_t)(Entry->sequence - Part->oldestSequence) < (uint16_t)(Part->nextSequence - Part->oldestSequence);
+}
+//**********************************************************************************************************************************************************
+void M24LC512_timeIndexInit(const uint8_t Id)
+{
+    uint8_t state = M24LC512_framUnlock();
+
+    timeIndex.partition = Id;
+    timeIndex.first = 0;
+    timeIndex.count = 0;
+
+    M24LC512_framRestore(state);
+}
+//**********************************************************************************************************************************************************
+void M24LC512_timeIndexAdd(const uint32_t Timestamp, const uint16_t Address)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(timeIndex.partition);
+    M24LC512_TimeEntry *entry;
+    uint16_t offset = Address % M24LC512_MAXPAGEWRITE;
+    uint8_t state;
+
+    // Solo se indexa el primer registro de una de cada M24LC512_TIME_INDEX_INTERVAL paginas.
+    if((part == 0) || (offset != M24LC512_stampSize(Address - offset)) ||
+       ((((Address / M24LC512_MAXPAGEWRITE) - part->startPage) % M24LC512_TIME_INDEX_INTERVAL) != 0))
+    {
+        return;
+    }
+
+    state = M24LC512_framUnlock();
+
+    if(timeIndex.count == M24LC512_TIME_INDEX_ENTRIES)
+    {
+        timeIndex.first = (timeIndex.first + 1) % M24LC512_TIME_INDEX_ENTRIES;
+        timeIndex.count--;
+    }
+
+    entry = &timeIndex.entry[(timeIndex.first + timeIndex.count) % M24LC512_TIME_INDEX_ENTRIES];
+    entry->timestamp = Timestamp;
+    entry->address = Address;
+    entry->sequence = part->nextSequence - 1;
+    timeIndex.count++;
+
+    M24LC512_framRestore(state);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_timeAppend(const uint32_t Timestamp, const uint8_t *Record, const uint8_t Length, uint16_t *Address)
+{
+    uint8_t stamp[M24LC512_TIME_SIZE];
+    uint16_t address;
+
+    if(Length > M24LC512_TIME_RECORD_MAX)
+    {
+        return false;
+    }
+
+    stamp[0] = (uint8_t)(Timestamp >> 24);
+    stamp[1] = (uint8_t)(Timestamp >> 16);
+    stamp[2] = (uint8_t)(Timestamp >> 8);
+    stamp[3] = (uint8_t)Timestamp;
+
+    if(!M24LC512_recordAppendPrefixed(timeIndex.partition, stamp, M24LC512_TIME_SIZE, Record, Length, &address))
+    {
+        return false;
+    }
+
+    if(Address != 0)
+    {
+        *Address = address;
+    }
+
+    M24LC512_timeIndexAdd(Timestamp, address);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_timeIndexSeek(const uint32_t From, M24LC512_RecordIterator *Iterator)
+{
+    const M24LC512_Partition *part = M24LC512_getPartition(timeIndex.partition);
+    const M24LC512_TimeEntry *entry;
+    uint16_t low = 0;
+    uint16_t high = timeIndex.count;
+    uint16_t middle;
+
+    if(part == 0)
+    {
+        return false;
+    }
+
+    // Las entradas invalidas son siempre las mas viejas: se busca la primera valida.
+    while(low < high)
+    {
+        middle = low + ((high - low) / 2);
+        if(M24LC512_timeEntryIsValid(part, M24LC512_timeEntry(middle)))
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    // Entre las validas se busca la primera con marca de tiempo posterior a From; la anterior es el punto de partida.
+    high = timeIndex.count;
+    while(low < high)
+    {
+        middle = low + ((high - low) / 2);
+        if(M24LC512_timeEntry(middle)->timestamp <= From)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if((low > 0) && M24LC512_timeEntryIsValid(part, M24LC512_timeEntry(low - 1)))
+    {
+        entry = M24LC512_timeEntry(low - 1);
+        if(M24LC512_recordSeek(timeIndex.partition, Iterator, entry->address, entry->sequence))
+        {
+            return true;
+        }
+    }
+
+    // From es anterior a todas las entradas: se empieza por el registro mas viejo.
+    return M24LC512_recordBegin(timeIndex.partition, Iterator);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_timeQueryBegin(const uint32_t From, const uint32_t To, M24LC512_TimeQuery *Query)
+{
+    Query->from = From;
+    Query->to = To;
+
+    return M24LC512_timeIndexSeek(From, &Query->iterator);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_timeQueryNext(M24LC512_TimeQuery *Query, uint32_t *Timestamp, uint8_t *Data, uint8_t *Length)
+{
+    uint32_t timestamp;
+    uint8_t length;
+
+    while(M24LC512_recordNext(&Query->iterator, Data, &length))
+    {
+        if(length < M24LC512_TIME_SIZE)
+        {
+            continue;                                               // No es un registro con marca de tiempo
+        }
+
+        timestamp = ((uint32_t)Data[0] << 24) | ((uint32_t)Data[1] << 16) | ((uint32_t)Data[2] << 8) | Data[3];
+
+        if(timestamp > Query->to)
+        {
+            Query->iterator.remaining = 0;                          // Los registros siguientes son posteriores al rango
+            break;
+        }
+
+        if(timestamp >= Query->from)
+        {
+            *Timestamp = timestamp;
+            *Length = length - M24LC512_TIME_SIZE;
+            memmove(Data, &Data[M24LC512_TIME_SIZE], *Length);
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,195 @@
+/**
+  * @file     timeindex.h
+  * @brief    ndice por marca de tiempo de los registros de la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// timeindex.h - ndice por marca de tiempo de los registros de la memoria
+//               24LC512.
+//
+//*****************************************************************************
+
+#ifndef TIMEINDEX_H_
+#define TIMEINDEX_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "record.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Cantidad de entradas del ndice guardado en la FRAM.
+//*****************************************************************************
+#define M24LC512_TIME_INDEX_ENTRIES     64
+
+//*****************************************************************************
+//! \details Se agrega una entrada al ndice cada esta cantidad de pginas de
+//!          la particin. Con 64 entradas cada 8 pginas se cubre la memoria
+//!          completa.
+//*****************************************************************************
+#define M24LC512_TIME_INDEX_INTERVAL    8
+
+//*****************************************************************************
+//! \details Tamao de la marca de tiempo que se antepone a cada registro.
+//*****************************************************************************
+#define M24LC512_TIME_SIZE              4
+
+//*****************************************************************************
+//! \details Tamao mximo de los datos de un registro con marca de tiempo.
+//*****************************************************************************
+#define M24LC512_TIME_RECORD_MAX        (M24LC512_RECORD_MAX - M24LC512_TIME_SIZE)
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Entrada del ndice: primer registro de una pgina.
+//*****************************************************************************
+typedef struct
+{
+    uint32_t timestamp;     //!< Marca de tiempo del registro.
+    uint16_t address;       //!< Direccin del encabezado del registro.
+    uint16_t sequence;      //!< Nmero de secuencia del registro.
+} M24LC512_TimeEntry;
+
+//*****************************************************************************
+//! \details ndice circular guardado en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint8_t partition;      //!< Particin indexada.
+    uint8_t reserved;
+    uint16_t first;         //!< Posicin de la entrada ms vieja.
+    uint16_t count;         //!< Cantidad de entradas.
+    M24LC512_TimeEntry entry[M24LC512_TIME_INDEX_ENTRIES];
+} M24LC512_TimeIndex;
+
+//*****************************************************************************
+//! \details Estado de una consulta por rango de tiempo.
+//*****************************************************************************
+typedef struct
+{
+    M24LC512_RecordIterator iterator;
+    uint32_t from;          //!< Comienzo del rango.
+    uint32_t to;            //!< Fin del rango, inclusive.
+} M24LC512_TimeQuery;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Selecciona la particin de registros que se indexa.
+//!
+//! \details \b Descripcin \n
+//!          Borra el ndice y lo asocia a la particin \b Id. Los registros
+//!          de esa particin se deben escribir con \a M24LC512_timeAppend().
+//!
+//! \param Id Nmero de particin.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+void M24LC512_timeIndexInit(const uint8_t Id);
+
+//*****************************************************************************
+//! \brief Agrega un registro con marca de tiempo.
+//!
+//! \details \b Descripcin \n
+//!          Escribe el registro con la marca de tiempo antepuesta usando
+//!          \a M24LC512_recordAppendPrefixed(). Si el registro es el primero
+//!          de una pgina mltiplo de \b M24LC512_TIME_INDEX_INTERVAL se
+//!          agrega una entrada al ndice, descartando la ms vieja si est
+//!          lleno. Las marcas de tiempo deben ser crecientes, por ejemplo el
+//!          contador de segundos del RTC.
+//!
+//! \param Timestamp Marca de tiempo del registro.
+//! \param *Record Datos del registro.
+//! \param Length Tamao de los datos, hasta \b M24LC512_TIME_RECORD_MAX.
+//! \param *Address Si no es 0 devuelve la direccin del encabezado del
+//!        registro.
+//!
+//! \return \c true si se escribi el registro.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_timeAppend(const uint32_t Timestamp, const uint8_t *Record,
+                         const uint8_t Length, uint16_t *Address);
+
+//*****************************************************************************
+//! \brief Agrega al ndice un registro recin escrito.
+//!
+//! \details \b Descripcin \n
+//!          Para los mdulos que guardan la marca de tiempo con su propio
+//!          formato. Se debe llamar justo despus de escribir el registro en
+//!          la particin indexada; solo se agrega una entrada si el registro
+//!          es el primero de una pgina mltiplo de
+//!          \b M24LC512_TIME_INDEX_INTERVAL.
+//!
+//! \param Timestamp Marca de tiempo del registro.
+//! \param Address Direccin del encabezado del registro.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+void M24LC512_timeIndexAdd(const uint32_t Timestamp, const uint16_t Address);
+
+//*****************************************************************************
+//! \brief Posiciona un iterador cerca de una marca de tiempo.
+//!
+//! \details \b Descripcin \n
+//!          Busca en el ndice, con bsqueda binaria y sin leer la EEPROM,
+//!          la ltima entrada anterior o igual a \b From que todava est en
+//!          la particin y coloca el iterador en ese registro, que siempre es
+//!          el primero de una pgina. Si no hay ninguna lo coloca en el
+//!          registro ms viejo.
+//!
+//! \param From Marca de tiempo buscada.
+//! \param *Iterator Iterador a inicializar.
+//!
+//! \return \c true si la particin indexada est configurada.
+//*****************************************************************************
+bool M24LC512_timeIndexSeek(const uint32_t From,
+                            M24LC512_RecordIterator *Iterator);
+
+//*****************************************************************************
+//! \brief Prepara la consulta de los registros entre dos marcas de tiempo.
+//!
+//! \details \b Descripcin \n
+//!          Coloca la consulta con \a M24LC512_timeIndexSeek(), as solo se
+//!          leen las pginas que contienen el rango pedido.
+//!
+//! \param From Comienzo del rango.
+//! \param To Fin del rango, inclusive.
+//! \param *Query Consulta a inicializar.
+//!
+//! \return \c true si la particin indexada est configurada.
+//*****************************************************************************
+bool M24LC512_timeQueryBegin(const uint32_t From, const uint32_t To,
+                             M24LC512_TimeQuery *Query);
+
+//*****************************************************************************
+//! \brief Lee el prximo registro del rango consultado.
+//!
+//! \param *Query Consulta inicializada con \a M24LC512_timeQueryBegin().
+//! \param *Timestamp Devuelve la marca de tiempo del registro.
+//! \param *Data Buffer de al menos \b M24LC512_RECORD_MAX bytes, devuelve
+//!        los datos sin la marca de tiempo.
+//! \param *Length Devuelve el tamao de los datos.
+//!
+//! \return \c false al terminar el rango.
+//*****************************************************************************
+bool M24LC512_timeQueryNext(M24LC512_TimeQuery *Query, uint32_t *Timestamp,
+                            uint8_t *Data, uint8_t *Length);
+
+#endif /* TIMEINDEX_H_ */
@@ -0,0 +1,164 @@
+/*
+ * txn.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// txn.c - Escrituras de varias pginas con diario de rehacer en la FRAM.
+//
+//*****************************************************************************
+
+#include <string.h>
+
+#include "txn.h"
+
+// El diario se guarda en la FRAM principal: sobrevive al reset que corta la escritura en la EEPROM.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(journal)
+static M24LC512_Journal journal = {0};
+#elif defined(__GNUC__)
+static M24LC512_Journal journal __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+//**********************************************************************************************************************************************************
+static void M24LC512_txnSetState(const uint16_t State)
+{
+    uint8_t state = M24LC512_framUnlock();
+
+    journal.state = State;                                      // Una palabra alineada: la FRAM la escribe de una vez
+
+    M24LC512_framRestore(state);
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_txnApply(void)
+{
+    const M24LC512_TxnEntry *entry;
+    uint16_t i;
+    bool ok = true;
+
+    for(i = 0 ; i < journal.count ; i++)
+    {
+        entry = &journal.entry[i];
+
+        if(!M24LC512_pageProgram(entry->address, &journal.data[entry->offset], entry->size))
+        {
+            ok = false;
+        }
+    }
+
+    M24LC512_txnSetState(M24LC512_TXN_IDLE);
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_txnBegin(void)
+{
+    uint8_t state;
+
+    if(journal.state == M24LC512_TXN_COMMITTED)
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    journal.count = 0;
+    journal.used = 0;
+    journal.state = M24LC512_TXN_OPEN;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_txnWrite(const uint16_t Address, const uint8_t *Data, const uint16_t Size)
+{
+    M24LC512_TxnEntry *entry;
+    uint16_t address = Address;
+    uint16_t size = Size;
+    uint16_t chunkSize;
+    uint16_t pages;
+    uint8_t state;
+
+    if(journal.state != M24LC512_TXN_OPEN)
+    {
+        return false;
+    }
+
+    // Se verifica antes de copiar nada que todas las paginas entren en el diario.
+    pages = ((Address % M24LC512_MAXPAGEWRITE) + Size + M24LC512_MAXPAGEWRITE - 1) / M24LC512_MAXPAGEWRITE;
+    if((Size == 0) || ((journal.count + pages) > M24LC512_TXN_ENTRIES) || (Size > (M24LC512_TXN_BYTES - journal.used)))
+    {
+        return false;
+    }
+
+    state = M24LC512_framUnlock();
+
+    // Cada entrada queda dentro de una pagina, como la escribe M24LC512_pageProgram().
+    while(size > 0)
+    {
+        chunkSize = M24LC512_MAXPAGEWRITE - (address % M24LC512_MAXPAGEWRITE);
+        if(chunkSize > size)
+        {
+            chunkSize = size;
+        }
+
+        entry = &journal.entry[journal.count];
+        entry->address = address;
+        entry->offset = journal.used;
+        entry->size = (uint8_t)chunkSize;
+        memcpy(&journal.data[journal.used], Data, chunkSize);
+
+        journal.used += chunkSize;
+        journal.count++;
+
+        address += chunkSize;
+        Data += chunkSize;
+        size -= chunkSize;
+    }
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_txnCommit(void)
+{
+    if(journal.state != M24LC512_TXN_OPEN)
+    {
+        return false;
+    }
+
+    // Punto de confirmacion: desde aca un reset termina en una nueva aplicacion completa.
+    M24LC512_txnSetState(M24LC512_TXN_COMMITTED);
+
+    return M24LC512_txnApply();
+}
+//**********************************************************************************************************************************************************
+void M24LC512_txnAbort(void)
+{
+    if(journal.state == M24LC512_TXN_OPEN)
+    {
+        M24LC512_txnSetState(M24LC512_TXN_IDLE);
+    }
+}
+//**********************************************************************************************************************************************************
+uint8_t M24LC512_txnRecover(void)
+{
+    if(journal.state == M24LC512_TXN_COMMITTED)
+    {
+        M24LC512_txnApply();
+        return M24LC512_TXN_REPLAYED;
+    }
+
+    if(journal.state != M24LC512_TXN_IDLE)
+    {
+        M24LC512_txnSetState(M24LC512_TXN_IDLE);
+        return M24LC512_TXN_DISCARDED;
+    }
+
+    return M24LC512_TXN_CLEAN;
+}
@@ -0,0 +1,163 @@
+/**
+  * @file     txn.h
+  * @brief    Escrituras de varias pginas con diario de rehacer en la FRAM.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// txn.h - Escrituras de varias pginas con diario de rehacer en la FRAM.
+//
+//*****************************************************************************
+
+#ifndef TXN_H_
+#define TXN_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "memory.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Bytes de datos que puede guardar el diario (cuatro pginas).
+//*****************************************************************************
+#define M24LC512_TXN_BYTES          (4 * M24LC512_MAXPAGEWRITE)
+
+//*****************************************************************************
+//! \details Cantidad mxima de escrituras de una transaccin. Una escritura
+//!          que cruza pginas ocupa una entrada por pgina.
+//*****************************************************************************
+#define M24LC512_TXN_ENTRIES        8
+
+//*****************************************************************************
+//! \details Estado del diario.
+//*****************************************************************************
+//! @name Estados del diario
+//! @{
+#define M24LC512_TXN_IDLE           0x0000  //!< Sin transaccin.
+#define M24LC512_TXN_OPEN           0x0001  //!< Se estn agregando escrituras.
+#define M24LC512_TXN_COMMITTED      0xA5C3  //!< Confirmada, falta aplicarla.
+//! @}
+
+//*****************************************************************************
+//! \details Resultado de \a M24LC512_txnRecover().
+//*****************************************************************************
+//! @name Recuperacin
+//! @{
+#define M24LC512_TXN_CLEAN          0   //!< No haba transaccin pendiente.
+#define M24LC512_TXN_DISCARDED      1   //!< Se descart una sin confirmar.
+#define M24LC512_TXN_REPLAYED       2   //!< Se volvi a aplicar una confirmada.
+//! @}
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Escritura de una transaccin, dentro de una pgina.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t address;       //!< Direccin de la memoria.
+    uint16_t offset;        //!< Posicin de los datos en el diario.
+    uint8_t size;           //!< Cantidad de datos.
+    uint8_t reserved;
+} M24LC512_TxnEntry;
+
+//*****************************************************************************
+//! \details Diario de rehacer, guardado en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint16_t state;         //!< \b M24LC512_TXN_IDLE, \b OPEN o \b COMMITTED.
+    uint16_t count;         //!< Escrituras de la transaccin.
+    uint16_t used;          //!< Bytes de datos usados.
+    M24LC512_TxnEntry entry[M24LC512_TXN_ENTRIES];
+    uint8_t data[M24LC512_TXN_BYTES];
+} M24LC512_Journal;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Comienza una transaccin.
+//!
+//! \details \b Descripcin \n
+//!          Descarta cualquier transaccin sin confirmar.
+//!
+//! \return \c false si hay una transaccin confirmada sin aplicar (se debe
+//!         llamar antes a \a M24LC512_txnRecover()).
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_txnBegin(void);
+
+//*****************************************************************************
+//! \brief Agrega una escritura a la transaccin.
+//!
+//! \details \b Descripcin \n
+//!          Copia los datos al diario de la FRAM; la EEPROM no se toca hasta
+//!          \a M24LC512_txnCommit(). Los datos pueden cruzar pginas y se
+//!          escriben sin sello.
+//!
+//! \param Address Direccin de la memoria.
+//! \param *Data Datos.
+//! \param Size Cantidad de datos.
+//!
+//! \return \c false si no hay una transaccin abierta o no entra en el
+//!         diario.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_txnWrite(const uint16_t Address, const uint8_t *Data,
+                       const uint16_t Size);
+
+//*****************************************************************************
+//! \brief Confirma y aplica la transaccin.
+//!
+//! \details \b Descripcin \n
+//!          Marca el diario como confirmado con una sola escritura en la
+//!          FRAM y recin entonces escribe cada pgina en la EEPROM. Si un
+//!          reset corta la aplicacin, \a M24LC512_txnRecover() la repite
+//!          completa: escribir dos veces los mismos datos da el mismo
+//!          resultado, as que no hace falta releer la memoria.
+//!
+//! \return \c true si se aplicaron todas las escrituras.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_txnCommit(void);
+
+//*****************************************************************************
+//! \brief Descarta la transaccin abierta.
+//!
+//! \return \c void.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+void M24LC512_txnAbort(void);
+
+//*****************************************************************************
+//! \brief Completa o descarta la transaccin cortada por un reset.
+//!
+//! \details \b Descripcin \n
+//!          Se llama al arrancar, antes de usar la memoria. Una transaccin
+//!          confirmada se vuelve a aplicar y una abierta se descarta, de
+//!          modo que cada transaccin queda escrita completa o no queda.
+//!
+//! \return \b M24LC512_TXN_CLEAN, \b M24LC512_TXN_DISCARDED o
+//!         \b M24LC512_TXN_REPLAYED.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+uint8_t M24LC512_txnRecover(void);
+
+#endif /* TXN_H_ */
@@ -0,0 +1,184 @@
+/*
+ * wear.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Matas Lpez - Jess Lpez
+ */
+//*****************************************************************************
+//
+// wear.c - Nivelacin de desgaste de pginas fijas de la memoria 24LC512.
+//
+//*****************************************************************************
+
+#include <string.h>
+
+#include "wear.h"
+#include "workbuf.h"
+
+// El mapa y los contadores se guardan en la FRAM principal para que sobrevivan a un reset.
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma PERSISTENT(wear)
+static M24LC512_Wear wear = {0};
+#elif defined(__GNUC__)
+static M24LC512_Wear wear __attribute__ ((persistent)) = {0};
+#else
+#error Compiler not supported!
+#endif
+
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_wearAddress(const uint16_t Physical)
+{
+    return (wear.startPage + Physical) * M24LC512_MAXPAGEWRITE;
+}
+//**********************************************************************************************************************************************************
+static bool M24LC512_wearProgram(const uint16_t Physical, const uint8_t *Data, const uint8_t Size)
+{
+    uint8_t state;
+    bool ok;
+
+    ok = M24LC512_pageProgram(M24LC512_wearAddress(Physical), Data, Size);
+
+    state = M24LC512_framUnlock();
+    wear.writes[Physical]++;
+    M24LC512_framRestore(state);
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+static uint16_t M24LC512_wearSpare(void)
+{
+    uint8_t used[(M24LC512_WEAR_PAGES + 7) / 8] = {0};
+    uint16_t i;
+
+    // La libre es la unica fisica que no aparece en el mapa. Se calcula en lugar de guardarla, asi cada cambio del mapa
+    // es una sola escritura de 16 bits en la FRAM y un reset nunca deja dos paginas logicas en la misma fisica.
+    for(i = 0 ; i < M24LC512_WEAR_LOGICAL ; i++)
+    {
+        used[wear.map[i] / 8] |= 1 << (wear.map[i] % 8);
+    }
+    for(i = 0 ; i < M24LC512_WEAR_PAGES ; i++)
+    {
+        if(!(used[i / 8] & (1 << (i % 8))))
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+//**********************************************************************************************************************************************************
+static void M24LC512_wearRemap(const uint16_t Logical, const uint16_t Physical)
+{
+    uint8_t state = M24LC512_framUnlock();
+
+    wear.map[Logical] = Physical;
+
+    M24LC512_framRestore(state);
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_wearInit(const uint16_t StartPage)
+{
+    uint8_t state;
+    uint16_t i;
+
+    if(!M24LC512_reserveZone(M24LC512_ZONE_WEAR, StartPage, M24LC512_WEAR_PAGES))
+    {
+        return false;
+    }
+
+    // El mapa y los contadores de la FRAM sobreviven a un reset: volver a llamar con la misma zona no los pierde.
+    if((wear.pageCount != 0) && (wear.startPage == StartPage))
+    {
+        return true;
+    }
+
+    state = M24LC512_framUnlock();
+
+    wear.pageCount = 0;                                             // Se deshabilita mientras se inicializa
+    wear.startPage = StartPage;
+    for(i = 0 ; i < M24LC512_WEAR_LOGICAL ; i++)
+    {
+        wear.map[i] = i;
+    }
+    for(i = 0 ; i < M24LC512_WEAR_PAGES ; i++)
+    {
+        wear.writes[i] = 0;
+    }
+    wear.pageCount = M24LC512_WEAR_PAGES;
+
+    M24LC512_framRestore(state);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_wearWrite(const uint16_t Logical, const uint8_t *Data, const uint8_t Size)
+{
+    uint16_t physical;
+    uint16_t spare;
+    uint16_t coldLogical = 0;
+    uint16_t i;
+    bool ok;
+
+    if((wear.pageCount == 0) || (Logical >= M24LC512_WEAR_LOGICAL) || (Size > M24LC512_MAXPAGEWRITE))
+    {
+        return false;
+    }
+
+    physical = wear.map[Logical];
+
+    // Se busca la pagina logica cuya fisica tiene menos escrituras.
+    for(i = 1 ; i < M24LC512_WEAR_LOGICAL ; i++)
+    {
+        if(wear.writes[wear.map[i]] < wear.writes[wear.map[coldLogical]])
+        {
+            coldLogical = i;
+        }
+    }
+
+    if((coldLogical != Logical) &&
+       (wear.writes[physical] > (wear.writes[wear.map[coldLogical]] + M24LC512_WEAR_THRESHOLD)))
+    {
+        // La pagina fria se copia a la libre; la fisica que deja recibe los datos de la pagina caliente.
+        spare = M24LC512_wearSpare();
+        M24LC512_sequentialRead(M24LC512_wearAddress(wear.map[coldLogical]), M24LC512_workBuffer, M24LC512_MAXPAGEWRITE);
+        if(!M24LC512_wearProgram(spare, M24LC512_workBuffer, M24LC512_MAXPAGEWRITE))
+        {
+            return false;                                           // La pagina fria queda donde estaba
+        }
+        M24LC512_wearRemap(coldLogical, spare);
+
+        // La pagina caliente se mueve entera: los bytes que no cubren los datos nuevos se copian de la actual.
+        spare = M24LC512_wearSpare();                               // La fisica que dejo la pagina fria
+        M24LC512_sequentialRead(M24LC512_wearAddress(physical), M24LC512_workBuffer, M24LC512_MAXPAGEWRITE);
+        memcpy(M24LC512_workBuffer, Data, Size);
+        ok = M24LC512_wearProgram(spare, M24LC512_workBuffer, M24LC512_MAXPAGEWRITE);
+        if(ok)
+        {
+            M24LC512_wearRemap(Logical, spare);                     // y la gastada queda libre
+        }
+    }
+    else
+    {
+        ok = M24LC512_wearProgram(physical, Data, Size);
+    }
+
+    return ok;
+}
+//**********************************************************************************************************************************************************
+bool M24LC512_wearRead(const uint16_t Logical, const uint8_t Offset, uint8_t *Data, const uint8_t Size)
+{
+    if((wear.pageCount == 0) || (Logical >= M24LC512_WEAR_LOGICAL) || (Size == 0) ||
+       (((uint16_t)Offset + Size) > M24LC512_MAXPAGEWRITE))
+    {
+        return false;
+    }
+
+    M24LC512_readRange(M24LC512_wearAddress(wear.map[Logical]) + Offset, Data, Size);
+
+    return true;
+}
+//**********************************************************************************************************************************************************
+uint32_t M24LC512_wearWrites(const uint16_t Physical)
+{
+    return (Physical < M24LC512_WEAR_PAGES) ? wear.writes[Physical] : 0;
+}
@@ -0,0 +1,128 @@
+/**
+  * @file     wear.h
+  * @brief    Nivelacin de desgaste de pginas fijas de la memoria 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// wear.h - Nivelacin de desgaste de pginas fijas de la memoria 24LC512.
+//
+//*****************************************************************************
+
+#ifndef WEAR_H_
+#define WEAR_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "partition.h"
+
+//*****************************************************************************
+//                              Define
+//*****************************************************************************
+//*****************************************************************************
+//! \details Pginas fsicas de la zona con nivelacin de desgaste.
+//*****************************************************************************
+#define M24LC512_WEAR_PAGES         64
+
+//*****************************************************************************
+//! \details Pginas lgicas: una pgina fsica queda libre para las
+//!          migraciones.
+//*****************************************************************************
+#define M24LC512_WEAR_LOGICAL       (M24LC512_WEAR_PAGES - 1)
+
+//*****************************************************************************
+//! \details Diferencia de escrituras entre la pgina ms usada y la menos
+//!          usada a partir de la cual se migra la pgina lgica.
+//*****************************************************************************
+#define M24LC512_WEAR_THRESHOLD     1000UL
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Estado de la nivelacin de desgaste, guardado en la FRAM.
+//*****************************************************************************
+typedef struct
+{
+    uint32_t writes[M24LC512_WEAR_PAGES];   //!< Escrituras de cada pgina fsica.
+    uint16_t map[M24LC512_WEAR_LOGICAL];    //!< Pgina fsica de cada pgina lgica.
+    uint16_t startPage;                     //!< Primera pgina de la zona.
+    uint16_t pageCount;                     //!< Cero si la zona no est configurada.
+} M24LC512_Wear;
+
+//*****************************************************************************
+//                              Funciones prototipos
+//*****************************************************************************
+//*****************************************************************************
+//! \brief Configura la zona con nivelacin de desgaste.
+//!
+//! \details \b Descripcin \n
+//!          La zona ocupa \b M24LC512_WEAR_PAGES pginas desde \b StartPage,
+//!          que se reservan como \b M24LC512_ZONE_WEAR con
+//!          \a M24LC512_reserveZone(). Si la zona ya est
+//!          configurada en esa pgina se conservan el mapa de pginas
+//!          lgicas a fsicas y los contadores de escrituras de la FRAM; si
+//!          no, se inicializan.
+//!
+//! \param StartPage Primera pgina de la zona.
+//!
+//! \return \c true si la zona entra en la memoria y no se superpone con
+//!         una particin ni con otra zona.
+//!
+//! \attention Modifica los bits del registro \b SYSCFG0 mientras escribe la
+//!            FRAM.
+//*****************************************************************************
+bool M24LC512_wearInit(const uint16_t StartPage);
+
+//*****************************************************************************
+//! \brief Escribe una pgina lgica.
+//!
+//! \details \b Descripcin \n
+//!          Escribe los datos al comienzo de la pgina fsica asociada y
+//!          cuenta la escritura. Si la pgina super a la menos usada en
+//!          \b M24LC512_WEAR_THRESHOLD escrituras, primero se copia la pgina
+//!          lgica menos usada a la pgina libre y los datos nuevos se
+//!          escriben, junto con el resto de la pgina, en la fsica que sta
+//!          dej; la pgina gastada pasa a ser la libre. El mapa solo se actualiza luego de cada escritura y la
+//!          pgina libre es la que no figura en el mapa, as un reset no deja
+//!          una pgina lgica sin datos vlidos.
+//!
+//! \param Logical Pgina lgica, menor a \b M24LC512_WEAR_LOGICAL.
+//! \param *Data Datos a escribir.
+//! \param Size Cantidad de datos, hasta \b M24LC512_MAXPAGEWRITE.
+//!
+//! \return \c true si se escribi la pgina y, con la verificacin
+//!         habilitada, coincidi al releerla.
+//!
+//! \attention Modifica los bits de los registros \b UCB0CTLW0, \b UCB0IFG,
+//!            \b UCB0TXBUF ,\b UCB0RXBUF, \b SR, \b UCB0IE y \b SYSCFG0.
+//*****************************************************************************
+bool M24LC512_wearWrite(const uint16_t Logical, const uint8_t *Data,
+                        const uint8_t Size);
+
+//*****************************************************************************
+//! \brief Lee una pgina lgica.
+//!
+//! \param Logical Pgina lgica.
+//! \param Offset Posicin dentro de la pgina.
+//! \param *Data Buffer donde se guardan los datos ledos.
+//! \param Size Cantidad de datos, sin pasar el final de la pgina.
+//!
+//! \return \c true si se leyeron los datos.
+//*****************************************************************************
+bool M24LC512_wearRead(const uint16_t Logical, const uint8_t Offset,
+                       uint8_t *Data, const uint8_t Size);
+
+//*****************************************************************************
+//! \brief Devuelve las escrituras de una pgina fsica de la zona.
+//!
+//! \param Physical Pgina fsica, menor a \b M24LC512_WEAR_PAGES.
+//!
+//! \return Cantidad de escrituras.
+//*****************************************************************************
+uint32_t M24LC512_wearWrites(const uint16_t Physical);
+
+#endif /* WEAR_H_ */
@@ -0,0 +1,38 @@
+/**
+  * @file     workbuf.h
+  * @brief    Buffer de trabajo interno de la librera 24LC512.
+  * @date     Created on: 18 oct. 2026
+  * @authors  Matas Lpez - Jess Lpez
+  * @version  1.0
+  */
+//*****************************************************************************
+//
+// workbuf.h - Buffer de trabajo interno de la librera 24LC512. Solo lo
+//             incluyen los .c de la librera; no forma parte de la API.
+//
+//*****************************************************************************
+
+#ifndef WORKBUF_H_
+#define WORKBUF_H_
+
+//*****************************************************************************
+//                              Include
+//*****************************************************************************
+#include "memory.h"
+
+//*****************************************************************************
+//                              Estructuras
+//*****************************************************************************
+//*****************************************************************************
+//! \details Buffer de una pgina compartido por los mdulos de la librera.
+//!          La pila es de solo 160 bytes, as que las copias de una pgina o
+//!          de un registro quedan en RAM esttica. Ninguna funcin conserva
+//!          su contenido entre dos llamadas ni lo usa mientras llama a otro
+//!          mdulo que tambin lo usa. Se puede pasar como datos a
+//!          \a M24LC512_pageProgram() y \a M24LC512_pageWrite(): la
+//!          reubicacin de una pgina que falla la verificacin usa su
+//!          propia copia. No lo debe usar una interrupcin.
+//*****************************************************************************
+extern uint8_t M24LC512_workBuffer[M24LC512_MAXPAGEWRITE];
+
+#endif /* WORKBUF_H_ */